@@ -4,6 +4,7 @@
       'target_name' : 'eos',
       'sources' : [ 
         'src/buffer.hpp', 'src/buffer.cpp',
+        'src/column.hpp', 'src/column.cpp',
         'src/handle.hpp', 'src/handle.cpp',
         'src/eos.hpp', 'src/eos.cpp',
         'src/env.hpp', 'src/env.cpp',
@@ -12,19 +13,32 @@
           'src/conn.driverConnect.cpp',
           'src/conn.disconnect.cpp',
           'src/conn.browseConnect.cpp',
+        'src/metadata.hpp', 'src/metadata.cpp',
+        'src/numeric.hpp', 'src/numeric.cpp',
         'src/operation.hpp', 'src/operation.cpp',
         'src/parameter.hpp', 'src/parameter.cpp',
+        'src/pool.hpp', 'src/pool.cpp',
+        'src/result.hpp', 'src/result.cpp',
         'src/stmt.hpp', 'src/stmt.cpp',
           'src/stmt.describeCol.cpp',
+          'src/stmt.describeResultSet.cpp',
           'src/stmt.execDirect.cpp',
           'src/stmt.execute.cpp',
+          'src/stmt.executeBatch.cpp',
           'src/stmt.fetch.cpp',
+          'src/stmt.fetchColumns.cpp',
+          'src/stmt.fetchRow.cpp',
+          'src/stmt.fetchRows.cpp',
+          'src/stmt.fetchRowsAhead.cpp',
+          'src/stmt.free.cpp',
           'src/stmt.getData.cpp',
           'src/stmt.moreResults.cpp',
           'src/stmt.numResultCols.cpp',
           'src/stmt.paramData.cpp',
+          'src/stmt.pipeline.cpp',
           'src/stmt.prepare.cpp',
-          'src/stmt.putData.cpp'
+          'src/stmt.putData.cpp',
+        'src/workers.hpp', 'src/workers.cpp'
       ],
       'defines' : [
         'UNICODE'
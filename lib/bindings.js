@@ -3,3 +3,6 @@ try {
 } catch (e) {
     module.exports = require("../build/Release/eos.node");
 }
+
+require("./query").install(module.exports);
+require("./pool").install(module.exports);
@@ -1,4 +1,5 @@
 var bindings = require("./bindings"),
+    streams = require("./streams"),
     assert = require("assert"),
     co = require("co");
 
@@ -181,4 +182,29 @@ Statement.prototype.closeCursor = function (canThrow) {
     this.handle.closeCursor(canThrow);
 };
 
+Statement.prototype.prepare = function (sql) {
+    var self = this;
+    return function (callback) {
+        self.handle.prepare(sql, callback);
+    };
+};
+
+Statement.prototype.execDirect = function (sql) {
+    var self = this;
+    return function (callback) {
+        self.handle.execDirect(sql, callback);
+    };
+};
+
+// Returns a Readable stream (in object mode) over the current result set.
+Statement.prototype.createReadStream = function (options) {
+    return new streams.ResultStream(this.handle, options);
+};
+
+// Returns a Writable stream (in object mode) which executes the prepared
+// statement for each row written to it, in batches.
+Statement.prototype.createWriteStream = function (options) {
+    return new streams.BatchStream(this.handle, options);
+};
+
 module.exports.internals = { parseConnectionString: parseConnectionString };
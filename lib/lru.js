@@ -0,0 +1,101 @@
+/*
+  A map from strings to values which holds at most capacity entries, evicting
+  the least recently used entry when a new one is added to a full map. Evicted
+  entries are passed to onEvict (if given), e.g. so that a handle can be freed.
+*/
+function LRU(capacity, onEvict) {
+    this.capacity = capacity;
+    this.onEvict = onEvict;
+    this.size = 0;
+    this.entries = Object.create(null);
+
+    // A circular doubly-linked list of entries, most recently used first
+    this.head = { key: null, value: null };
+    this.head.prev = this.head.next = this.head;
+}
+
+LRU.prototype._unlink = function (entry) {
+    entry.prev.next = entry.next;
+    entry.next.prev = entry.prev;
+};
+
+LRU.prototype._linkFirst = function (entry) {
+    entry.prev = this.head;
+    entry.next = this.head.next;
+    this.head.next.prev = entry;
+    this.head.next = entry;
+};
+
+// Returns the value for key (marking it as the most recently used), or undefined.
+LRU.prototype.get = function (key) {
+    var entry = this.entries[key];
+    if (!entry)
+        return undefined;
+
+    this._unlink(entry);
+    this._linkFirst(entry);
+    return entry.value;
+};
+
+// Returns the value for key without affecting the order of eviction.
+LRU.prototype.peek = function (key) {
+    var entry = this.entries[key];
+    return entry ? entry.value : undefined;
+};
+
+LRU.prototype.set = function (key, value) {
+    var entry = this.entries[key];
+    if (entry) {
+        entry.value = value;
+        this._unlink(entry);
+        this._linkFirst(entry);
+        return;
+    }
+
+    if (this.capacity <= 0)
+        return this._evicted(key, value);
+
+    this.evict(this.capacity - 1);
+
+    entry = { key: key, value: value };
+    this.entries[key] = entry;
+    this._linkFirst(entry);
+    this.size++;
+};
+
+// Removes the entry for key without calling onEvict, and returns its value.
+LRU.prototype.remove = function (key) {
+    var entry = this.entries[key];
+    if (!entry)
+        return undefined;
+
+    this._unlink(entry);
+    delete this.entries[key];
+    this.size--;
+    return entry.value;
+};
+
+// Evicts the least recently used entries until there are at most size left.
+LRU.prototype.evict = function (size) {
+    while (this.size > size) {
+        var entry = this.head.prev;
+        this.remove(entry.key);
+        this._evicted(entry.key, entry.value);
+    }
+};
+
+LRU.prototype.setCapacity = function (capacity) {
+    this.capacity = capacity;
+    this.evict(Math.max(capacity, 0));
+};
+
+LRU.prototype.clear = function () {
+    this.evict(0);
+};
+
+LRU.prototype._evicted = function (key, value) {
+    if (this.onEvict)
+        this.onEvict(value, key);
+};
+
+module.exports = LRU;
@@ -0,0 +1,307 @@
+/*
+  A pool of connections to one data source.
+
+  open() connects min connections at once (each driverConnect runs on the
+  thread pool, so they connect in parallel). acquire() hands out an idle
+  connection if there is one, or else connects a new one if the pool is not
+  yet at max, or else waits; waiting callers are served in FIFO order. An idle
+  connection is checked with SQL_ATTR_CONNECTION_DEAD (no round trip) before
+  it is handed out. release() asks the driver to reset the session and gives
+  the connection straight to the next waiter, if any (or disconnects it, if
+  the driver can't reset it). Connections above min
+  which have been idle for longer than idleTimeoutMs are disconnected.
+*/
+
+function Pool(bindings, options) {
+    options = options || {};
+
+    if (typeof options.connectionString !== "string")
+        throw new TypeError("The connection string should be a string");
+
+    this.bindings = bindings;
+    this.connectionString = options.connectionString;
+    this.env = options.environment || new bindings.Environment();
+    this.min = options.min || 0;
+    this.max = options.max || 10;
+    this.idleTimeoutMs = options.idleTimeoutMs === undefined ? 30000 : options.idleTimeoutMs;
+    this.acquireTimeoutMs = options.acquireTimeoutMs || 0;
+    this.reuseWithoutReset = !!options.reuseWithoutReset;
+
+    if (this.max < 1 || this.min > this.max)
+        throw new RangeError("The pool size should be at least 1, and at least min");
+
+    // Most recently released last, so that the least used connections age out
+    this.idle = [];
+    this.waiting = [];
+    this.busy = 0;
+    this.connecting = 0;
+    this.closed = false;
+
+    this.acquired = 0;
+    this.waits = 0;
+    this.totalWaitMs = 0;
+    this.maxWaitMs = 0;
+
+    this.timer = null;
+}
+
+Pool.prototype.size = function () {
+    return this.idle.length + this.busy + this.connecting;
+};
+
+// Connects min connections, calling back once they are all connected (or
+// with the first error).
+Pool.prototype.open = function (callback) {
+    var self = this,
+        remaining = this.min - this.size(),
+        failed = null;
+
+    this._startEvicting();
+
+    if (remaining <= 0)
+        return process.nextTick(function () { callback(null); });
+
+    for (var i = 0; i < remaining; i++) {
+        this._connect(function (err, conn) {
+            if (err)
+                failed = failed || err;
+            else
+                self._makeIdle(conn);
+
+            if (--remaining === 0)
+                callback(failed);
+        });
+    }
+};
+
+Pool.prototype.acquire = function (callback) {
+    if (this.closed)
+        return process.nextTick(function () { callback(new Error("The pool is closed")); });
+
+    this._startEvicting();
+
+    var conn = this._takeIdle();
+    if (conn) {
+        this.acquired++;
+        this.busy++;
+        return process.nextTick(function () { callback(null, conn); });
+    }
+
+    var waiter = { callback: callback, start: Date.now(), timer: null },
+        self = this;
+
+    if (this.acquireTimeoutMs > 0) {
+        waiter.timer = setTimeout(function () {
+            var i = self.waiting.indexOf(waiter);
+            if (i >= 0) {
+                self.waiting.splice(i, 1);
+                callback(new Error("Timed out waiting for a connection"));
+            }
+        }, this.acquireTimeoutMs);
+    }
+
+    this.waiting.push(waiter);
+
+    if (this.size() < this.max)
+        this._grow();
+};
+
+// Returns a connection to the pool. Pass true for discard if the connection
+// should not be reused (e.g. after an error which may have broken it).
+Pool.prototype.release = function (conn, discard) {
+    this.busy--;
+
+    if (discard || this.closed || this._isDead(conn))
+        return this._destroy(conn);
+
+    // Without a reset, open transactions, temporary tables and SET options
+    // would be passed on to the next caller. Eos has no SQLEndTran to roll
+    // back with instead, so the connection is disconnected.
+    try {
+        if (!conn.resetSession() && !this.reuseWithoutReset)
+            return this._destroy(conn);
+    } catch (err) {
+        return this._destroy(conn);
+    }
+
+    this._makeIdle(conn);
+};
+
+Pool.prototype._makeIdle = function (conn) {
+    if (this.closed)
+        return this._destroy(conn);
+
+    var waiter = this.waiting.shift();
+    if (waiter)
+        return this._handOver(waiter, conn);
+
+    conn._idleSince = Date.now();
+    this.idle.push(conn);
+};
+
+Pool.prototype._handOver = function (waiter, conn) {
+    if (waiter.timer)
+        clearTimeout(waiter.timer);
+
+    var waited = Date.now() - waiter.start;
+    this.waits++;
+    this.totalWaitMs += waited;
+    this.maxWaitMs = Math.max(this.maxWaitMs, waited);
+
+    this.acquired++;
+    this.busy++;
+    waiter.callback(null, conn);
+};
+
+// Returns the most recently released idle connection which is still alive.
+Pool.prototype._takeIdle = function () {
+    while (this.idle.length > 0) {
+        var conn = this.idle.pop();
+        if (!this._isDead(conn))
+            return conn;
+
+        this._destroy(conn);
+    }
+
+    return null;
+};
+
+Pool.prototype._isDead = function (conn) {
+    try {
+        return conn.isDead();
+    } catch (err) {
+        return true;
+    }
+};
+
+// Connects a connection for the first waiter (or whichever waiter is first
+// once it has connected).
+Pool.prototype._grow = function () {
+    var self = this;
+
+    this._connect(function (err, conn) {
+        if (!err)
+            return self._makeIdle(conn);
+
+        // The first waiter hears about the error. The others may have been
+        // counting on this connection, so connect again for them unless enough
+        // connections are already being connected (or there is no room).
+        var waiter = self.waiting.shift();
+        if (waiter) {
+            if (waiter.timer)
+                clearTimeout(waiter.timer);
+            waiter.callback(err);
+        }
+
+        if (!self.closed && self.waiting.length > self.connecting && self.size() < self.max)
+            self._grow();
+    });
+};
+
+Pool.prototype._connect = function (callback) {
+    var self = this,
+        conn = this.env.newConnection();
+
+    this.connecting++;
+    conn.driverConnect(this.connectionString, function (err) {
+        self.connecting--;
+
+        if (err) {
+            conn.free();
+            return callback(err);
+        }
+
+        callback(null, conn);
+    });
+};
+
+Pool.prototype._destroy = function (conn, callback) {
+    conn.disconnect(function () {
+        // The connection is freed even if disconnecting failed
+        conn.free();
+        if (callback)
+            callback();
+    });
+};
+
+Pool.prototype._startEvicting = function () {
+    var self = this;
+
+    if (this.timer || this.idleTimeoutMs <= 0 || this.closed)
+        return;
+
+    this.timer = setInterval(function () {
+        self._evictIdle();
+    }, Math.max(1000, this.idleTimeoutMs / 2));
+
+    // Idle connections alone shouldn't keep the process running
+    if (this.timer.unref)
+        this.timer.unref();
+};
+
+// Disconnects connections above min which have been idle for too long,
+// oldest first.
+Pool.prototype._evictIdle = function () {
+    var now = Date.now();
+
+    while (this.idle.length > 0 && this.size() > this.min && now - this.idle[0]._idleSince > this.idleTimeoutMs)
+        this._destroy(this.idle.shift());
+};
+
+// Disconnects every idle connection now, and the others as they are
+// released. Waiting callers get an error.
+Pool.prototype.close = function (callback) {
+    var self = this,
+        idle = this.idle,
+        remaining = idle.length;
+
+    this.closed = true;
+    this.idle = [];
+
+    if (this.timer) {
+        clearInterval(this.timer);
+        this.timer = null;
+    }
+
+    this.waiting.splice(0).forEach(function (waiter) {
+        if (waiter.timer)
+            clearTimeout(waiter.timer);
+        waiter.callback(new Error("The pool is closed"));
+    });
+
+    if (remaining === 0)
+        return callback && process.nextTick(callback);
+
+    idle.forEach(function (conn) {
+        self._destroy(conn, function () {
+            if (--remaining === 0 && callback)
+                callback();
+        });
+    });
+};
+
+Pool.prototype.stats = function () {
+    return {
+        size: this.size(),
+        idle: this.idle.length,
+        busy: this.busy,
+        connecting: this.connecting,
+        waiting: this.waiting.length,
+        min: this.min,
+        max: this.max,
+        utilization: this.busy / this.max,
+        acquired: this.acquired,
+        waited: this.waits,
+        averageWaitMs: this.acquired > 0 ? this.totalWaitMs / this.acquired : 0,
+        maxWaitMs: this.maxWaitMs
+    };
+};
+
+// Adds Pool to the bindings.
+exports.install = function (bindings) {
+    bindings.Pool = function (options) {
+        return new Pool(bindings, options);
+    };
+};
+
+exports.Pool = Pool;
@@ -0,0 +1,385 @@
+var LRU = require("./lru");
+
+/*
+  Connection.query(sql, [params], callback) runs a statement and returns the
+  rows of its first result set, keeping the statement handles of frequently
+  run SQL prepared.
+
+  SQL which has been run fewer than prepareThreshold times is executed with
+  execDirect on a spare statement handle. After that it is prepared once, and
+  the prepared handle is kept in a per-connection LRU keyed by the SQL text;
+  later calls only close its cursor and reset its parameters before executing
+  it again, instead of allocating and preparing a new handle. Handles evicted
+  from the LRU are freed on the thread pool.
+*/
+
+var DefaultCacheSize = 100,
+    DefaultPrepareThreshold = 5,
+    BatchSize = 100;
+
+function StatementCache(conn) {
+    var self = this;
+
+    this.conn = conn;
+    this.prepareThreshold = DefaultPrepareThreshold;
+    this.hits = this.misses = this.prepared = 0;
+
+    // SQL -> { sql, stmt, busy, retired } for prepared statements
+    this.statements = new LRU(DefaultCacheSize, function (entry) {
+        self._retire(entry);
+    });
+
+    // SQL -> the number of times it has been run without being prepared
+    this.uses = new LRU(DefaultCacheSize * 4);
+
+    // An idle statement handle for execDirect
+    this.spare = null;
+    this.closing = false;
+
+    // Handles which are being freed on the thread pool, and the callbacks of
+    // clear() which are waiting for them.
+    this.freeing = 0;
+    this.drained = [];
+
+    // Queries which haven't called back yet, and the callbacks of close()
+    // which are waiting for them (and for the handles to be freed).
+    this.running = 0;
+    this.closed = [];
+}
+
+StatementCache.prototype.query = function (sql, params, callback) {
+    var self = this;
+
+    if (this.closing) {
+        return process.nextTick(function () {
+            callback(new Error("The connection is being disconnected"));
+        });
+    }
+
+    // Called after the statement has been released (or freed)
+    this.running++;
+    var done = function (err, rows) {
+        self.running--;
+        self._checkClosed();
+        callback(err, rows);
+    };
+
+    this._query(sql, params, done);
+};
+
+StatementCache.prototype._query = function (sql, params, callback) {
+    var entry = this.statements.get(sql);
+
+    // A prepared statement which is already running (e.g. the same query
+    // issued twice in parallel) can't be shared, so run this one directly.
+    if (entry && !entry.busy) {
+        this.hits++;
+        return this._execute(entry, params, callback);
+    }
+
+    this.misses++;
+
+    if (!entry && this._shouldPrepare(sql))
+        return this._prepare(sql, params, callback);
+
+    this._execDirect(sql, params, callback);
+};
+
+StatementCache.prototype._shouldPrepare = function (sql) {
+    if (this.prepareThreshold <= 0 || this.statements.capacity <= 0)
+        return false;
+
+    var uses = (this.uses.get(sql) || 0) + 1;
+    if (uses >= this.prepareThreshold) {
+        this.uses.remove(sql);
+        return true;
+    }
+
+    this.uses.set(sql, uses);
+    return false;
+};
+
+StatementCache.prototype._newStatement = function () {
+    var stmt = this.conn.newStatement();
+    stmt.setRowMode("object");
+    return stmt;
+};
+
+StatementCache.prototype._prepare = function (sql, params, callback) {
+    var self = this,
+        entry = { sql: sql, stmt: this._newStatement(), busy: true, retired: false };
+
+    entry.stmt.prepare(sql, function (err) {
+        if (err) {
+            self._free(entry.stmt);
+            return callback(err);
+        }
+
+        self.prepared++;
+
+        // If the same SQL was prepared at the same time and that finished
+        // first, or the connection is being disconnected, this handle is only
+        // used once, and freed when it's released
+        if (self.closing || self.statements.peek(sql))
+            entry.retired = true;
+        else
+            self.statements.set(sql, entry);
+
+        self._execute(entry, params, callback);
+    });
+};
+
+StatementCache.prototype._execute = function (entry, params, callback) {
+    var self = this;
+
+    entry.busy = true;
+
+    try {
+        runPipeline(entry.stmt, [{ bind: params }, { execute: true }], function (err, rows) {
+            self._release(entry);
+            callback(err, rows);
+        });
+    } catch (err) {
+        this._release(entry);
+        callback(err);
+    }
+};
+
+StatementCache.prototype._execDirect = function (sql, params, callback) {
+    var self = this,
+        entry = { sql: sql, stmt: this.spare || this._newStatement(), busy: true, retired: false };
+
+    this.spare = null;
+
+    try {
+        runPipeline(entry.stmt, [{ bind: params }, { execDirect: sql }], function (err, rows) {
+            self._releaseSpare(entry);
+            callback(err, rows);
+        });
+    } catch (err) {
+        this._releaseSpare(entry);
+        callback(err);
+    }
+};
+
+// Closes the cursor and resets the parameters so that the handle can be
+// executed again, or frees it if it has been evicted meanwhile, the connection
+// is being disconnected (or it can't be reset).
+StatementCache.prototype._release = function (entry) {
+    entry.busy = false;
+
+    if (!entry.retired && !this.closing) {
+        try {
+            entry.stmt.closeCursor();
+            entry.stmt.unbindParameters();
+            return;
+        } catch (err) {
+            this.statements.remove(entry.sql);
+        }
+    }
+
+    this._free(entry.stmt);
+};
+
+StatementCache.prototype._releaseSpare = function (entry) {
+    entry.busy = false;
+
+    if (!this.spare && !this.closing) {
+        try {
+            entry.stmt.closeCursor();
+            entry.stmt.unbindParameters();
+            this.spare = entry.stmt;
+            return;
+        } catch (err) {
+            // Fall through and get rid of it
+        }
+    }
+
+    this._free(entry.stmt);
+};
+
+StatementCache.prototype._retire = function (entry) {
+    entry.retired = true;
+    if (!entry.busy)
+        this._free(entry.stmt);
+};
+
+StatementCache.prototype._free = function (stmt) {
+    var self = this;
+
+    this.freeing++;
+    stmt.free(function () {
+        // There is nothing useful to do if freeing fails
+        if (--self.freeing === 0) {
+            var drained = self.drained;
+            self.drained = [];
+            drained.forEach(function (cb) { cb(); });
+            self._checkClosed();
+        }
+    });
+};
+
+// Frees every handle, waiting for the queries which are running to finish
+// first, and calls back once they have all been freed. Later queries fail.
+StatementCache.prototype.close = function (callback) {
+    this.closing = true;
+    this.clear();
+    this.closed.push(callback);
+    this._checkClosed();
+};
+
+StatementCache.prototype._checkClosed = function () {
+    if (!this.closing || this.running > 0 || this.freeing > 0)
+        return;
+
+    this.closing = false;
+    var closed = this.closed;
+    this.closed = [];
+    closed.forEach(function (cb) { cb(); });
+};
+
+// Frees every idle handle, and calls back once they have all been freed.
+// Handles which are in use are freed when they are released.
+StatementCache.prototype.clear = function (callback) {
+    this.statements.clear();
+    this.uses.clear();
+
+    if (this.spare) {
+        this._free(this.spare);
+        this.spare = null;
+    }
+
+    if (!callback)
+        return;
+
+    if (this.freeing === 0)
+        return process.nextTick(callback);
+
+    this.drained.push(callback);
+};
+
+StatementCache.prototype.stats = function () {
+    return {
+        hits: this.hits,
+        misses: this.misses,
+        prepared: this.prepared,
+        size: this.statements.size,
+        capacity: this.statements.capacity,
+        prepareThreshold: this.prepareThreshold
+    };
+};
+
+// Binds the parameter values (choosing an SQL type for each from its
+// JavaScript type), executes and fetches the first block of rows in a single
+// operation, then fetches any remaining rows.
+function runPipeline(stmt, steps, callback) {
+    stmt.pipeline(steps.concat({ fetchRows: BatchSize }), function (err, results) {
+        if (err) {
+            // Invalid cursor state: the statement didn't return a result set
+            if (err.operation === "fetchRows" && err.state === "24000")
+                return callback(null, []);
+            return callback(err);
+        }
+
+        var rows = results[results.length - 1];
+
+        // A block can be short because its rows are wide, so only an empty
+        // one is the last
+        if (rows.length === 0)
+            return callback(null, rows);
+
+        fetchAll(stmt, function (err, more) {
+            if (err)
+                return callback(err);
+            callback(null, rows.concat(more));
+        });
+    });
+}
+
+// Fetches all of the rows of the current result set, if there is one.
+function fetchAll(stmt, callback) {
+    var rows = [];
+
+    stmt.fetchRows(BatchSize, function next(err, batch) {
+        if (err) {
+            // Invalid cursor state: the statement didn't return a result set
+            if (err.state === "24000" && rows.length === 0)
+                return callback(null, rows);
+            return callback(err);
+        }
+
+        if (batch.length === 0)
+            return callback(null, rows);
+
+        for (var i = 0; i < batch.length; i++)
+            rows.push(batch[i]);
+
+        stmt.fetchRows(BatchSize, next);
+    });
+}
+
+function getCache(conn) {
+    if (!conn._statementCache)
+        conn._statementCache = new StatementCache(conn);
+    return conn._statementCache;
+}
+
+// Adds query() and the statement cache methods to Connection.
+exports.install = function (bindings) {
+    var proto = bindings.Connection.prototype,
+        disconnect = proto.disconnect;
+
+    proto.query = function (sql, params, callback) {
+        if (typeof params === "function") {
+            callback = params;
+            params = [];
+        }
+
+        if (typeof sql !== "string")
+            throw new TypeError("The SQL should be a string");
+
+        if (typeof callback !== "function")
+            throw new TypeError("The last argument should be a callback");
+
+        if (params && !Array.isArray(params))
+            throw new TypeError("The parameters should be an array");
+
+        getCache(this).query(sql, params || [], callback);
+    };
+
+    proto.setStatementCacheSize = function (size) {
+        if (typeof size !== "number" || size < 0 || (size | 0) !== size)
+            throw new TypeError("The cache size must be a non-negative integer");
+
+        var cache = getCache(this);
+        cache.statements.setCapacity(size);
+        cache.uses.setCapacity(size * 4);
+    };
+
+    proto.setPrepareThreshold = function (threshold) {
+        if (typeof threshold !== "number" || threshold < 0 || (threshold | 0) !== threshold)
+            throw new TypeError("The prepare threshold must be a non-negative integer");
+
+        getCache(this).prepareThreshold = threshold;
+    };
+
+    proto.statementCacheStats = function () {
+        return getCache(this).stats();
+    };
+
+    proto.clearStatementCache = function (callback) {
+        getCache(this).clear(callback);
+    };
+
+    // Disconnecting frees every statement handle, so the cached ones have to
+    // be freed first, including those which queries are still using.
+    proto.disconnect = function (callback) {
+        var self = this, cache = this._statementCache;
+        if (!cache)
+            return disconnect.call(this, callback);
+
+        cache.close(function () {
+            disconnect.call(self, callback);
+        });
+    };
+};
@@ -0,0 +1,286 @@
+var stream = require("stream"),
+    util = require("util");
+
+/*
+  A Readable stream (in object mode) over the current result set of a statement
+  handle. Rows are fetched in blocks of batchSize using fetchRowsAhead, so the
+  next block is fetched while the consumer processes this one, but no further
+  ahead: a slow consumer does not cause rows to be buffered without limit.
+*/
+function ResultStream(stmtHandle, options) {
+    options = options || {};
+
+    stream.Readable.call(this, {
+        objectMode: true,
+        highWaterMark: options.highWaterMark || 16
+    });
+
+    this.handle = stmtHandle;
+    this.batchSize = options.batchSize || 100;
+    this.batches = !!options.batches;
+    this.fetching = false;
+    this.destroyed = false;
+}
+
+util.inherits(ResultStream, stream.Readable);
+
+ResultStream.prototype._read = function () {
+    var self = this;
+
+    if (self.fetching || self.destroyed)
+        return;
+
+    self.fetching = true;
+    self.handle.fetchRowsAhead(self.batchSize, function (err, rows) {
+        self.fetching = false;
+
+        // destroy() has already closed the cursor
+        if (self.destroyed)
+            return;
+
+        if (err) {
+            self._closeCursor();
+            return self.emit("error", err);
+        }
+
+        if (rows.length === 0) {
+            self._closeCursor();
+            return self.push(null);
+        }
+
+        if (self.batches)
+            return self.push(rows);
+
+        // push() returning false means the consumer is busy, but the rest of this
+        // block has already been fetched, so buffer it anyway; _read will not be
+        // called again until the buffer has drained.
+        for (var i = 0; i < rows.length; i++)
+            self.push(rows[i]);
+    });
+};
+
+ResultStream.prototype._closeCursor = function () {
+    try {
+        this.handle.closeCursor();
+    } catch (err) {
+        this.emit("error", err);
+    }
+};
+
+// Stops reading and closes the cursor (once any block being fetched has arrived).
+ResultStream.prototype.destroy = function () {
+    if (this.destroyed)
+        return;
+
+    this.destroyed = true;
+    this._closeCursor();
+    this.emit("close");
+};
+
+/*
+  A Writable stream (in object mode) which inserts rows using a prepared statement
+  handle. Rows (arrays of parameter values, or objects whose properties are picked
+  by the columns option) are collected column-wise and executed as one batch with
+  executeBatch whenever batchRows rows or about batchBytes bytes are waiting, or
+  flushIntervalMs after the first row of a batch. While a full batch is executing,
+  the write which filled it does not complete, so the stream's buffer fills up and
+  write() returns false until the batch is done.
+*/
+function BatchStream(stmtHandle, options) {
+    options = options || {};
+
+    this.batchRows = options.batchRows || 1000;
+    this.batchBytes = options.batchBytes || 4 * 1024 * 1024;
+    this.flushIntervalMs = options.flushIntervalMs || 0;
+
+    stream.Writable.call(this, {
+        objectMode: true,
+        highWaterMark: options.highWaterMark || this.batchRows
+    });
+
+    this.handle = stmtHandle;
+    this.names = options.columns || null;
+    this.types = options.types || [];
+    this.columns = null;
+    this.rows = 0;
+    this.bytes = 0;
+    this.executing = false;
+    this.waiting = null;
+    this.timer = null;
+
+    // The error of a batch flushed by the timer, which fails the next write
+    this.flushError = null;
+}
+
+util.inherits(BatchStream, stream.Writable);
+
+// Written (last) by end() to flush the final batch in order
+var EndOfRows = {};
+
+BatchStream.prototype._write = function (row, encoding, callback) {
+    var self = this;
+
+    if (this.flushError)
+        return this._failWrite(callback);
+
+    if (row === EndOfRows)
+        return this._whenIdle(function () { self._flush(callback); });
+
+    var values;
+    try {
+        values = this._values(row);
+    } catch (err) {
+        return callback(err);
+    }
+
+    if (!this.columns) {
+        this.columns = values.map(function () { return []; });
+    } else if (values.length !== this.columns.length) {
+        return callback(new Error("Every row should have " + this.columns.length + " values"));
+    }
+
+    for (var i = 0; i < values.length; i++) {
+        this.columns[i].push(values[i]);
+        this.bytes += estimateBytes(values[i]);
+    }
+
+    if (++this.rows >= this.batchRows || this.bytes >= this.batchBytes)
+        return this._whenIdle(function () { self._flush(callback); });
+
+    this._startTimer();
+    callback();
+};
+
+// Flushes the current batch flushIntervalMs from now, unless it fills up first.
+BatchStream.prototype._startTimer = function () {
+    var self = this;
+
+    if (this.flushIntervalMs <= 0 || this.timer)
+        return;
+
+    this.timer = setTimeout(function () {
+        self.timer = null;
+
+        // Rows written meanwhile are flushed once the batch has executed
+        if (self.executing)
+            return;
+
+        // No write is waiting for this batch, so a failure is passed to the
+        // next one (or to end())
+        self._flush(function (err) {
+            if (err)
+                self.flushError = err;
+        });
+    }, this.flushIntervalMs);
+};
+
+BatchStream.prototype._failWrite = function (callback) {
+    var err = this.flushError;
+    this.flushError = null;
+    callback(err);
+};
+
+BatchStream.prototype._values = function (row) {
+    if (Array.isArray(row))
+        return row;
+
+    if (!row || typeof row !== "object")
+        throw new TypeError("Rows should be arrays or objects");
+
+    if (!this.names)
+        this.names = Object.keys(row);
+
+    return this.names.map(function (name) { return row[name]; });
+};
+
+// Calls callback once no batch is executing. (Only the write which filled a
+// batch, or the end of the stream, ever has to wait, so there is at most one.)
+BatchStream.prototype._whenIdle = function (callback) {
+    if (this.executing)
+        this.waiting = callback;
+    else
+        callback();
+};
+
+BatchStream.prototype._flush = function (callback) {
+    var self = this;
+
+    if (this.timer) {
+        clearTimeout(this.timer);
+        this.timer = null;
+    }
+
+    // A write which waited for a batch flushed by the timer
+    if (this.flushError)
+        return this._failWrite(callback);
+
+    if (this.rows === 0)
+        return callback();
+
+    var types = this.types,
+        batch = this.columns.map(function (values, i) {
+            return types[i] ? { values: values, type: types[i] } : { values: values };
+        });
+
+    this.columns = null;
+    this.rows = this.bytes = 0;
+    this.executing = true;
+
+    var done = function (err, result) {
+        self.executing = false;
+
+        if (!err && result.failed > 0)
+            err = result.diagnostics[0] || new Error(result.failed + " rows could not be inserted");
+
+        if (!err)
+            self.emit("batch", result);
+
+        callback(err);
+
+        var waiting = self.waiting;
+        self.waiting = null;
+        if (waiting)
+            waiting();
+        else if (self.rows > 0)
+            self._startTimer();
+    };
+
+    // executeBatch throws if the values can't be marshalled (or the handle
+    // can't take another operation)
+    try {
+        this.handle.executeBatch(batch, done);
+    } catch (err) {
+        done(err);
+    }
+};
+
+// Flushes the rows which have not been executed yet before finishing.
+BatchStream.prototype.end = function (row, encoding, callback) {
+    if (typeof row === "function") {
+        callback = row;
+        row = null;
+    } else if (typeof encoding === "function") {
+        callback = encoding;
+    }
+
+    if (row !== null && row !== undefined)
+        this.write(row);
+
+    if (!this._writableState.ending)
+        this.write(EndOfRows);
+
+    stream.Writable.prototype.end.call(this, callback);
+};
+
+function estimateBytes(value) {
+    if (typeof value === "string")
+        return value.length * 2;
+    if (Buffer.isBuffer(value))
+        return value.length;
+    return 8;
+}
+
+module.exports = {
+    ResultStream: ResultStream,
+    BatchStream: BatchStream
+};
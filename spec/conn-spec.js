@@ -83,7 +83,204 @@ describe("For a connected connection", function () {
         });
     });
 
+    describe("isDead", function () {
+        it("should be false for a working connection", function () {
+            expect(conn.isDead()).to.equal(false);
+        });
+    });
+
+    describe("statement handles", function () {
+        it("should reuse the handle of a freed statement", function (done) {
+            var stmt = conn.newStatement();
+            stmt.execDirect("select 1", function (err) {
+                if (err)
+                    return done(err);
+
+                stmt.free(function (err) {
+                    if (err)
+                        return done(err);
+
+                    expect(conn.statementHandleCacheStats().idle).to.equal(1);
+
+                    var reused = conn.statementHandleCacheStats().reused;
+                    conn.newStatement().free();
+                    expect(conn.statementHandleCacheStats().reused).to.equal(reused + 1);
+                    done();
+                });
+            });
+        });
+
+        it("should not hand out a handle while disconnecting", function (done) {
+            conn.newStatement().free();
+
+            conn.disconnect(function (err) {
+                if (err)
+                    return done(err);
+
+                expect(conn.statementHandleCacheStats().idle).to.equal(0);
+                done();
+            });
+
+            expect(function () { conn.newStatement(); }).to.throw(/being disconnected/);
+        });
+    });
+
+    describe("metadataCache", function () {
+        it("should be emptied by disconnecting", function (done) {
+            var stmt = conn.newStatement();
+            stmt.prepare("select 1 as x", function (err) {
+                if (err)
+                    return done(err);
+
+                stmt.free();
+                expect(conn.metadataCacheStats().size).to.equal(1);
+
+                conn.disconnect(function (err) {
+                    if (err)
+                        return done(err);
+
+                    expect(conn.metadataCacheStats().size).to.equal(0);
+                    done();
+                });
+            });
+        });
+    });
+
+    describe("query", function () {
+        it("should prepare SQL once it has been run prepareThreshold times", function (done) {
+            var sql = "select ? as a, cast(N'x' as nvarchar(10)) as b";
+            conn.setPrepareThreshold(2);
+
+            conn.query(sql, [1], function (err, rows) {
+                if (err)
+                    return done(err);
+
+                expect(rows).to.deep.equal([{ a: 1, b: "x" }]);
+                expect(conn.statementCacheStats().prepared).to.equal(0);
+
+                conn.query(sql, [2], function (err, rows) {
+                    if (err)
+                        return done(err);
+
+                    expect(rows).to.deep.equal([{ a: 2, b: "x" }]);
+                    expect(conn.statementCacheStats().prepared).to.equal(1);
+
+                    conn.query(sql, [3], function (err, rows) {
+                        if (err)
+                            return done(err);
+
+                        var stats = conn.statementCacheStats();
+                        expect(rows).to.deep.equal([{ a: 3, b: "x" }]);
+                        expect(stats.prepared).to.equal(1);
+                        expect(stats.hits).to.equal(1);
+                        done();
+                    });
+                });
+            });
+        });
+
+        it("should not keep a statement prepared while disconnecting", function (done) {
+            var sql = "select ? as a";
+            conn.setPrepareThreshold(1);
+
+            conn.query(sql, [1], function (err) {
+                if (err)
+                    return done(err);
+            });
+
+            conn.disconnect(function (err) {
+                if (err)
+                    return done(err);
+
+                expect(conn.statementCacheStats().size).to.equal(0);
+
+                conn.driverConnect(common.settings.connectionString, function (err) {
+                    if (err)
+                        return done(err);
+
+                    conn.query(sql, [2], function (err, rows) {
+                        if (err)
+                            return done(err);
+
+                        expect(rows).to.deep.equal([{ a: 2 }]);
+                        expect(conn.statementCacheStats().hits).to.equal(0);
+                        done();
+                    });
+                });
+            });
+        });
+
+        it("should return no rows for statements without a result set", function (done) {
+            conn.query("declare @x int", function (err, rows) {
+                if (err)
+                    return done(err);
+
+                expect(rows).to.deep.equal([]);
+                done();
+            });
+        });
+    });
+
     afterEach(function () {
         conn.disconnect(conn.free.bind(conn));
     });
-});
\ No newline at end of file
+});
+
+describe("A connection pool", function () {
+    var pool;
+
+    beforeEach(function (done) {
+        pool = new eos.Pool({ connectionString: common.settings.connectionString, environment: common.env, min: 2, max: 2 });
+        pool.open(done);
+    });
+
+    it("should hand out connections to waiting callers in order", function (done) {
+        var order = [];
+
+        function use(i) {
+            pool.acquire(function (err, conn) {
+                if (err)
+                    return done(err);
+
+                order.push(i);
+                conn.query("select 1 as x", function (err) {
+                    pool.release(conn);
+                    if (err)
+                        return done(err);
+
+                    if (order.length === 4) {
+                        expect(order).to.deep.equal([0, 1, 2, 3]);
+                        expect(pool.stats().size).to.equal(2);
+                        done();
+                    }
+                });
+            });
+        }
+
+        for (var i = 0; i < 4; i++)
+            use(i);
+    });
+
+    afterEach(function (done) {
+        pool.close(done);
+    });
+});
+
+describe("A connection pool which can't connect", function () {
+    it("should fail every waiting caller", function (done) {
+        var pool = new eos.Pool({ connectionString: "Driver={No such driver}", environment: common.env, max: 1 }),
+            failed = 0;
+
+        function acquire() {
+            pool.acquire(function (err, conn) {
+                expect(err).to.exist;
+
+                if (++failed === 2)
+                    pool.close(done);
+            });
+        }
+
+        acquire();
+        acquire();
+    });
+});
@@ -35,6 +35,14 @@ describe("Environment", function () {
         });
     });
 
+    describe("Environment.bufferPoolStats", function () {
+        it("should return the buffer pool statistics", function () {
+            var stats = common.env.bufferPoolStats();
+            expect(stats).to.have.keys("hits", "misses", "bytesInUse", "bytesPooled");
+            expect(stats.bytesInUse).not.to.be.below(0);
+        });
+    });
+
     describe("Environment.dataSources", function () {
         it("should return an array", function () {
             var dataSources = common.env.dataSources();
@@ -95,6 +95,119 @@ describe("A connected connection", function() {
     });
 });
 
+describe("A result set stream", function() {
+    git("should emit every row and then end", function* () {
+        var c = yield newConnected(),
+            s = c.newStatement();
+
+        yield s.execDirect("select 1 as x union all select 2 union all select 3");
+
+        var rows = yield function (callback) {
+            var rows = [];
+            s.createReadStream({ batchSize: 2 })
+                .on("data", function (row) { rows.push(row); })
+                .on("error", callback)
+                .on("end", function () { callback(null, rows); });
+        };
+
+        expect(rows).to.deep.equal([[1], [2], [3]]);
+
+        s.free();
+        yield c.disconnect();
+        c.free();
+    });
+});
+
+describe("A batch insert stream", function() {
+    git("should insert every row written to it in batches", function* () {
+        var c = yield newConnected(),
+            s = c.newStatement();
+
+        yield s.execDirect("create table #stream (id int not null, name nvarchar(20) null)");
+        s.closeCursor();
+        yield s.prepare("insert into #stream (id, name) values (?, ?)");
+
+        var batches = yield function (callback) {
+            var batches = 0,
+                out = s.createWriteStream({ batchRows: 2 });
+
+            out.on("batch", function () { batches++; })
+               .on("error", callback)
+               .on("finish", function () { callback(null, batches); });
+
+            out.write({ id: 1, name: "one" });
+            out.write({ id: 2, name: null });
+            out.end({ id: 3, name: "three" });
+        };
+
+        expect(batches).to.equal(2);
+
+        yield s.execDirect("select count(*) from #stream");
+        var rows = yield function (callback) {
+            var rows = [];
+            s.createReadStream()
+                .on("data", function (row) { rows.push(row); })
+                .on("error", callback)
+                .on("end", function () { callback(null, rows); });
+        };
+
+        expect(rows).to.deep.equal([[3]]);
+
+        s.free();
+        yield c.disconnect();
+        c.free();
+    });
+
+    git("should fail a write whose batch can't be converted", function* () {
+        var c = yield newConnected(),
+            s = c.newStatement();
+
+        yield s.execDirect("create table #stream (id int not null)");
+        s.closeCursor();
+        yield s.prepare("insert into #stream (id) values (?)");
+
+        var err = yield function (callback) {
+            var out = s.createWriteStream({ batchRows: 2 });
+            out.on("error", function (err) { callback(null, err); });
+
+            out.write([1]);
+            out.write(["two"]);
+        };
+
+        expect(err.message).to.contain("could not be converted");
+
+        s.free();
+        yield c.disconnect();
+        c.free();
+    });
+});
+
+describe("The worker threads", function() {
+    git("should run statements on a connection's pinned thread", function*() {
+        eos.bindings.configureWorkers({ pinConnections: true });
+
+        try {
+            var c = yield* newConnected(),
+                before = eos.bindings.workerStats().completed;
+
+            expect(eos.bindings.workerStats().pinnedThreads).to.equal(1);
+
+            var s = c.newStatement();
+            yield s.execDirect("select 1");
+            s.free();
+
+            expect(eos.bindings.workerStats().completed).to.be.above(before);
+
+            yield c.disconnect();
+            c.free();
+
+            expect(eos.bindings.workerStats().pinnedThreads).to.equal(0);
+        } finally {
+            eos.bindings.configureWorkers({ pinConnections: false });
+        }
+    });
+});
+
 describe("Finally...", function() {
     it("there should be no active operations", function() {
         if(eos.bindings.activeOperations && eos.bindings.activeOperations().length > 0) {
@@ -34,6 +34,46 @@ describe("A newly created statement", function () {
         });
     });
 
+    it("should describe a statement prepared again from the connection's metadata cache", function (done) {
+        var sql = "select 1 as a, cast(N'x' as nvarchar(10)) as b where 1 = ?";
+        conn.clearMetadataCache(sql);
+
+        stmt.prepare(sql, function (err) {
+            if (err)
+                return done(err);
+
+            var stats = conn.metadataCacheStats();
+            var other = conn.newStatement();
+            other.prepare(sql, function (err) {
+                if (err)
+                    return done(err);
+
+                expect(conn.metadataCacheStats().hits).to.equal(stats.hits + 1);
+
+                other.bindParameter(1, eos.SQL_PARAM_INPUT, eos.SQL_INTEGER, undefined, undefined, 1);
+                other.execute(function (err) {
+                    if (err)
+                        return done(err);
+
+                    other.describeResultSet(function (err, columns) {
+                        if (err)
+                            return done(err);
+
+                        expect(columns.map(function (c) { return c.name; })).to.deep.equal(["a", "b"]);
+                        other.fetchRow(function (err, row) {
+                            other.free();
+                            if (err)
+                                return done(err);
+
+                            expect(row).to.deep.equal([1, "x"]);
+                            done();
+                        });
+                    });
+                });
+            });
+        });
+    });
+
     function testInputParam(val, kind, type, digits, cmp, gdType) {
         if (!cmp)
             cmp = function (x, y) { return x === y; };
@@ -311,6 +351,33 @@ describe("A prepared statement", function () {
         stmt.execute(done);
     });
 
+    it("should run operations queued on the statement in order", function (done) {
+        var results = [];
+
+        stmt.execute(function (err) {
+            results.push(err || "execute");
+        });
+        stmt.fetchRow(function (err, row) {
+            results.push(err || row[0]);
+        });
+        stmt.moreResults(function (err, hasData) {
+            results.push(err || hasData);
+            expect(results).to.deep.equal(["execute", 42, false]);
+            done();
+        });
+    });
+
+    it("should not allow changing bindings while an operation is running", function (done) {
+        stmt.execute(function (err) {
+            stmt.closeCursor();
+            done(err);
+        });
+
+        expect(function () { stmt.bindParameter(1, eos.SQL_PARAM_INPUT, eos.SQL_INTEGER, 0, 0, 1); }).to.throw();
+        expect(function () { stmt.unbindParameters(); }).to.throw();
+        expect(function () { stmt.bindColumn(1, eos.SQL_INTEGER); }).to.throw();
+    });
+
     it("should allow executing twice", function (done) {
         stmt.execute(function (err) {
             if (err) {
@@ -342,6 +409,633 @@ describe("A prepared statement", function () {
     });
 });
 
+describe("Re-executing a statement with new values", function () {
+    var conn, stmt;
+
+    beforeEach(function (done) {
+        common.conn(function (err, c) {
+            if (err)
+                return done(err);
+
+            conn = c;
+            stmt = c.newStatement();
+            stmt.prepare("select ? as n, ? as s", done);
+        });
+    });
+
+    it("should rebind the values in place with executeWith", function (done) {
+        var params = stmt.bindParameters([
+            { type: eos.SQL_INTEGER },
+            { type: eos.SQL_WVARCHAR, columnSize: 4000 }
+        ]);
+
+        expect(params.length).to.equal(2);
+
+        stmt.executeWith([1, "a"], function (err) {
+            if (err)
+                return done(err);
+
+            stmt.fetchRow(function (err, row) {
+                if (err)
+                    return done(err);
+
+                expect(row).to.deep.equal([1, "a"]);
+                stmt.closeCursor();
+
+                // Longer than the buffer which was allocated for "a"
+                var longer = new Array(101).join("xyzzy");
+                stmt.executeWith([2, longer], function (err) {
+                    if (err)
+                        return done(err);
+
+                    stmt.fetchRow(function (err, row) {
+                        if (err)
+                            return done(err);
+
+                        expect(row).to.deep.equal([2, longer]);
+                        done();
+                    });
+                });
+            });
+        });
+    });
+
+    afterEach(function () {
+        stmt.free();
+        conn.disconnect(conn.free.bind(conn));
+    });
+});
+
+describe("Fetching a block of rows", function () {
+    var conn, stmt;
+
+    beforeEach(function (done) {
+        common.conn(function (err, c) {
+            if (err)
+                return done(err);
+
+            conn = c;
+            stmt = c.newStatement();
+            stmt.execDirect("select 1 as x, N'a' as y union all select 2, null union all select 3, N'ccc'", done);
+        });
+    });
+
+    it("should return rows in batches with fetchRows", function (done) {
+        stmt.fetchRows(2, function (err, rows) {
+            if (err)
+                return done(err);
+
+            expect(rows).to.deep.equal([[1, "a"], [2, null]]);
+
+            stmt.fetchRows(2, function (err, rows) {
+                if (err)
+                    return done(err);
+
+                expect(rows).to.deep.equal([[3, "ccc"]]);
+
+                stmt.fetchRows(2, function (err, rows) {
+                    if (err)
+                        return done(err);
+
+                    expect(rows).to.be.empty;
+                    done();
+                });
+            });
+        });
+    });
+
+    it("should fail rather than truncate values longer than 64KiB", function (done) {
+        stmt.closeCursor();
+        stmt.execDirect("select replicate(cast(N'x' as nvarchar(max)), 40000) as long", function (err) {
+            if (err)
+                return done(err);
+
+            stmt.fetchRows(1, function (err, rows) {
+                stmt.closeCursor();
+                expect(err).to.be.an.instanceof(Error);
+                expect(rows).to.be.undefined;
+                done();
+            });
+        });
+    });
+
+    it("should return fewer rows than asked for when they are wide", function (done) {
+        stmt.closeCursor();
+        stmt.execDirect("select top 2000 cast(N'x' as nvarchar(max)) as wide from sys.all_objects a cross join sys.all_objects b", function (err) {
+            if (err)
+                return done(err);
+
+            var blocks = 0, total = 0;
+            stmt.fetchRows(5000, function next(err, rows) {
+                if (err)
+                    return done(err);
+
+                if (rows.length === 0) {
+                    expect(blocks).to.be.above(1);
+                    expect(total).to.equal(2000);
+                    return done();
+                }
+
+                blocks++;
+                total += rows.length;
+                stmt.fetchRows(5000, next);
+            });
+        });
+    });
+
+    it("should return columns as typed arrays with fetchColumns", function (done) {
+        stmt.fetchColumns(10, function (err, columns, rowCount) {
+            if (err)
+                return done(err);
+
+            expect(rowCount).to.equal(3);
+            expect(columns[0].name).to.equal("x");
+            expect(columns[0].values).to.be.an.instanceof(Int32Array);
+            expect(Array.prototype.slice.call(columns[0].values)).to.deep.equal([1, 2, 3]);
+            expect(columns[1].values).to.deep.equal(["a", null, "ccc"]);
+            expect(columns[1].nulls[0]).to.equal(2);
+            done();
+        });
+    });
+
+    it("should read ahead with fetchRowsAhead", function (done) {
+        var blocks = [];
+
+        function next() {
+            stmt.fetchRowsAhead(2, function (err, rows) {
+                if (err)
+                    return done(err);
+
+                if (rows.length === 0) {
+                    expect(blocks).to.deep.equal([[[1, "a"], [2, null]], [[3, "ccc"]]]);
+                    return done();
+                }
+
+                expect(function () { stmt.fetch(function () {}); }).to.throw();
+
+                blocks.push(rows);
+                next();
+            });
+        }
+
+        next();
+    });
+
+    it("should stop reading ahead once the block being fetched arrives when the cursor is closed", function (done) {
+        stmt.fetchRowsAhead(1, function (err, rows) {
+            if (err)
+                return done(err);
+
+            expect(rows).to.be.empty;
+
+            stmt.execDirect("select 42", function (err) {
+                if (err)
+                    return done(err);
+
+                stmt.fetchRows(1, function (err, rows) {
+                    if (err)
+                        return done(err);
+
+                    expect(rows).to.deep.equal([[42]]);
+                    done();
+                });
+            });
+        });
+
+        expect(function () { stmt.closeCursor(); }).not.to.throw();
+    });
+
+    it("should return timestamps as UTC milliseconds in 'number' mode", function (done) {
+        stmt.closeCursor();
+        stmt.setTimestampMode("number");
+        stmt.execDirect("select cast('2014-02-03 04:05:06.789' as datetime2(3)) as t", function (err) {
+            if (err)
+                return done(err);
+
+            stmt.fetchRows(1, function (err, rows) {
+                if (err)
+                    return done(err);
+
+                expect(rows).to.deep.equal([[Date.UTC(2014, 1, 3, 4, 5, 6, 789)]]);
+                done();
+            });
+        });
+    });
+
+    it("should return exact decimals and bigints as strings in 'string' mode", function (done) {
+        stmt.closeCursor();
+        stmt.setNumericMode("string");
+        stmt.execDirect("select cast('-12345678901234567890.1234567890' as decimal(38,10)) as d, cast(9007199254740993 as bigint) as b", function (err) {
+            if (err)
+                return done(err);
+
+            stmt.fetchRows(1, function (err, rows) {
+                stmt.setNumericMode("number");
+                stmt.closeCursor();
+                if (err)
+                    return done(err);
+
+                expect(rows).to.deep.equal([["-12345678901234567890.1234567890", "9007199254740993"]]);
+                done();
+            });
+        });
+    });
+
+    it("should return rows as objects in 'object' mode", function (done) {
+        stmt.closeCursor();
+        stmt.setRowMode("object");
+        stmt.execDirect("select 1 as a, N'x' as b union all select 2, N'y'", function (err) {
+            if (err)
+                return done(err);
+
+            stmt.fetchRows(2, function (err, rows) {
+                stmt.setRowMode("array");
+                stmt.closeCursor();
+                if (err)
+                    return done(err);
+
+                expect(rows).to.deep.equal([{ a: 1, b: "x" }, { a: 2, b: "y" }]);
+                done();
+            });
+        });
+    });
+
+    it("should describe every column of a result set at once", function (done) {
+        stmt.closeCursor();
+        stmt.execDirect("select 1 as a, cast(N'x' as nvarchar(10)) as b", function (err) {
+            if (err)
+                return done(err);
+
+            stmt.describeResultSet(function (err, columns) {
+                stmt.closeCursor();
+                if (err)
+                    return done(err);
+
+                expect(columns.length).to.equal(2);
+                expect(columns[0].name).to.equal("a");
+                expect(columns[0].dataType).to.equal(eos.SQL_INTEGER);
+                expect(columns[0].nullable).to.equal(false);
+                expect(columns[1].name).to.equal("b");
+                expect(columns[1].octetLength).to.equal(20);
+                done();
+            });
+        });
+    });
+
+    it("should return whole rows with fetchRow", function (done) {
+        stmt.fetchRow(function (err, row) {
+            if (err)
+                return done(err);
+
+            expect(row).to.deep.equal([1, "a"]);
+            stmt.closeCursor();
+
+            var longString = new Array(20001).join("xyzzy");
+            stmt.execDirect("select replicate(cast(N'xyzzy' as nvarchar(max)), 20000) as x", function (err) {
+                if (err)
+                    return done(err);
+
+                stmt.fetchRow(function (err, row) {
+                    if (err)
+                        return done(err);
+
+                    expect(row[0]).to.equal(longString);
+                    done();
+                });
+            });
+        });
+    });
+
+    it("should fill bound columns in place on each execution", function (done) {
+        stmt.bindColumn(1, eos.SQL_INTEGER);
+        var y = stmt.bindColumn(2, eos.SQL_WVARCHAR, 64);
+
+        stmt.closeCursor();
+        stmt.execDirect("select 7 as x, N'xyzzy' as y", function (err) {
+            if (err)
+                return done(err);
+
+            stmt.fetch(function (err, hasData) {
+                if (err)
+                    return done(err);
+                if (!hasData)
+                    return done("No results");
+
+                expect(y.value).to.equal("xyzzy");
+                stmt.unbindColumns();
+                done();
+            });
+        });
+    });
+
+    afterEach(function () {
+        stmt.free();
+        conn.disconnect(conn.free.bind(conn));
+    });
+});
+
+describe("Fetching a long string", function () {
+    var conn, stmt, value = new Array(10001).join("ab\u0100");
+
+    beforeEach(function (done) {
+        common.conn(function (err, c) {
+            if (err)
+                return done(err);
+
+            conn = c;
+            stmt = c.newStatement();
+            stmt.execDirect("select replicate(cast(N'ab' + nchar(256) as nvarchar(max)), 10000) as long", done);
+        });
+    });
+
+    it("should return the whole value with getData", function (done) {
+        stmt.fetch(function (err, hasData) {
+            if (err)
+                return done(err);
+
+            expect(hasData).to.be.true;
+
+            stmt.getData(1, eos.SQL_WVARCHAR, null, false, function (err, result, _, more) {
+                if (err)
+                    return done(err);
+
+                expect(more).to.be.false;
+                expect(result.length).to.equal(value.length);
+                expect(result === value).to.be.true;
+                done();
+            });
+        });
+    });
+
+    it("should return the whole value with fetchRow", function (done) {
+        stmt.fetchRow(function (err, row) {
+            if (err)
+                return done(err);
+
+            expect(row[0].length).to.equal(value.length);
+            expect(row[0] === value).to.be.true;
+            done();
+        });
+    });
+
+    afterEach(function () {
+        stmt.free();
+        conn.disconnect(conn.free.bind(conn));
+    });
+});
+
+describe("Converting strings", function () {
+    var conn, stmt;
+
+    beforeEach(function (done) {
+        common.conn(function (err, c) {
+            if (err)
+                return done(err);
+
+            conn = c;
+            stmt = c.newStatement();
+            done();
+        });
+    });
+
+    // Strings are narrowed 16 and 32 characters at a time, with the rest
+    // done one by one, and on the heap above 1024 characters.
+    var lengths = [0, 1, 15, 16, 17, 31, 32, 33, 1500];
+
+    function makeString(length, kind) {
+        var chars = [];
+        for (var i = 0; i < length; i++) {
+            if (kind === "Latin-1")
+                chars.push(String.fromCharCode(i % 2 ? 0x80 + i % 0x80 : 0x61 + i % 26));
+            else
+                chars.push(String.fromCharCode(0x61 + i % 26));
+        }
+
+        // A wide character in the body goes through the vector code (for long
+        // enough strings), and one at the end through the scalar code
+        if (length > 0 && kind === "wide at the start")
+            chars[0] = "\u0101";
+        if (length > 0 && kind === "wide at the end")
+            chars[length - 1] = "\u20ac";
+
+        return chars.join("");
+    }
+
+    function testString(length, kind) {
+        var value = makeString(length, kind);
+
+        it("should return " + kind + " values of " + length + " characters", function (done) {
+            stmt.bindParameter(1, eos.SQL_PARAM_INPUT, eos.SQL_WVARCHAR, null, 0, value);
+            stmt.execDirect("select ? as x", function (err) {
+                if (err)
+                    return done(err);
+
+                stmt.fetchRow(function (err, row) {
+                    if (err)
+                        return done(err);
+
+                    expect(row[0].length).to.equal(length);
+                    expect(row[0] === value).to.be.true;
+                    done();
+                });
+            });
+        });
+
+        // Error messages are measured with sqlwcslen (and can't be over 1024)
+        if (length === 0 || length > 1000)
+            return;
+
+        it("should return " + kind + " error messages of " + length + " characters", function (done) {
+            stmt.bindParameter(1, eos.SQL_PARAM_INPUT, eos.SQL_WVARCHAR, null, 0, value);
+            stmt.execDirect("declare @message nvarchar(2047) = ?; raiserror(@message, 16, 1)", function (err) {
+                expect(err).to.exist;
+                expect(err.message).to.contain(value);
+                done();
+            });
+        });
+    }
+
+    ["ASCII", "Latin-1", "wide at the start", "wide at the end"].forEach(function (kind) {
+        lengths.forEach(function (length) {
+            if (length > 0 || kind === "ASCII")
+                testString(length, kind);
+        });
+    });
+
+    afterEach(function () {
+        stmt.free();
+        conn.disconnect(conn.free.bind(conn));
+    });
+});
+
+describe("Running a pipeline of steps", function () {
+    var conn, stmt;
+
+    beforeEach(function (done) {
+        common.conn(function (err, c) {
+            if (err)
+                return done(err);
+
+            conn = c;
+            stmt = c.newStatement();
+            done();
+        });
+    });
+
+    it("should prepare, bind, execute and fetch in one call", function (done) {
+        stmt.pipeline([
+            { prepare: "select ? as n, ? as s union all select 2, null" },
+            { bind: [1, "a"] },
+            { execute: true },
+            { fetchRows: 10 },
+            { closeCursor: true }
+        ], function (err, results) {
+            if (err)
+                return done(err);
+
+            expect(results).to.have.length(5);
+            expect(results[3]).to.deep.equal([[1, "a"], [2, null]]);
+            done();
+        });
+    });
+
+    it("should stop at the first step which fails", function (done) {
+        stmt.pipeline([
+            { execDirect: "select 1" },
+            { closeCursor: true },
+            { execDirect: "select * from no_such_table" },
+            { fetchRows: 10 }
+        ], function (err, results) {
+            expect(err).to.exist;
+            expect(err.step).to.equal(2);
+            expect(err.operation).to.equal("execDirect");
+            expect(results).to.have.length(2);
+            done();
+        });
+    });
+
+    afterEach(function () {
+        stmt.free();
+        conn.disconnect(conn.free.bind(conn));
+    });
+});
+
+describe("Executing a batch of parameter sets", function () {
+    var conn, stmt;
+
+    beforeEach(function (done) {
+        common.conn(function (err, c) {
+            if (err)
+                return done(err);
+
+            conn = c;
+            stmt = c.newStatement();
+            stmt.execDirect("create table #batch (id int not null primary key, name nvarchar(20) null)", function (err) {
+                if (err)
+                    return done(err);
+
+                stmt.prepare("insert into #batch (id, name) values (?, ?)", done);
+            });
+        });
+    });
+
+    it("should insert every row with executeBatch", function (done) {
+        stmt.executeBatch([[1, "one"], [2, null], [3, "three"]], function (err, result) {
+            if (err)
+                return done(err);
+
+            expect(result.rowCount).to.equal(3);
+            expect(result.processed).to.equal(3);
+            expect(result.failed).to.equal(0);
+            for (var i = 0; i < 3; i++)
+                expect(result.status[i]).to.equal(eos.SQL_PARAM_SUCCESS);
+            done();
+        });
+    });
+
+    it("should report the status of each row with columns of values", function (done) {
+        var columns = [
+            { values: [4, 4, 5] },
+            { values: ["four", "again", "five"], type: eos.SQL_WVARCHAR, columnSize: 20 }
+        ];
+
+        stmt.executeBatch(columns, function (err, result) {
+            // The duplicate key fails; whether the batch as a whole fails, and
+            // what happens to the later rows, is up to the driver.
+            expect(result.status[0]).to.equal(eos.SQL_PARAM_SUCCESS);
+            expect(result.status[1]).to.not.equal(eos.SQL_PARAM_SUCCESS);
+            done();
+        });
+    });
+
+    it("should bind typed arrays and their null masks without copying", function (done) {
+        var columns = [
+            { values: new Int32Array([10, 11, 12]) },
+            { values: new Float64Array([1.5, 0, 2.5]), nulls: new Uint8Array([2]) }
+        ];
+
+        stmt.executeBatch(columns, function (err, result) {
+            if (err)
+                return done(err);
+
+            expect(result.rowCount).to.equal(3);
+
+            var check = conn.newStatement();
+            check.execDirect("select count(*) as n from #batch where id >= 10 and name is null", function (err) {
+                if (err)
+                    return done(err);
+
+                check.fetchRow(function (err, row) {
+                    check.free();
+                    if (err)
+                        return done(err);
+
+                    expect(row[0]).to.equal(1);
+                    done();
+                });
+            });
+        });
+    });
+
+    it("should not round decimals when no scale is given", function (done) {
+        var dec = conn.newStatement();
+        dec.execDirect("create table #decimals (d decimal(10, 3) not null)", function (err) {
+            if (err)
+                return done(err);
+
+            dec.prepare("insert into #decimals (d) values (?)", function (err) {
+                if (err)
+                    return done(err);
+
+                var columns = [{ values: [1.5, "2.25", 3], type: eos.SQL_DECIMAL, columnSize: 10 }];
+                dec.executeBatch(columns, function (err) {
+                    if (err)
+                        return done(err);
+
+                    dec.execDirect("select sum(d) from #decimals", function (err) {
+                        if (err)
+                            return done(err);
+
+                        dec.fetchRow(function (err, row) {
+                            dec.free();
+                            if (err)
+                                return done(err);
+
+                            expect(row[0]).to.equal(6.75);
+                            done();
+                        });
+                    });
+                });
+            });
+        });
+    });
+
+    afterEach(function () {
+        stmt.free();
+        conn.disconnect(conn.free.bind(conn));
+    });
+});
+
 describe("Cancelling statement operations", function () {
     var conn, stmt;
 
@@ -373,6 +1067,31 @@ describe("Cancelling statement operations", function () {
         }, 500);
     });
 
+    it("should call back queued operations with SQLSTATE HY008 from cancelQueued()", function (done) {
+        var executed = false;
+
+        stmt.execute(function (err) {
+            executed = true;
+        });
+
+        // Queued behind the execute
+        stmt.moreResults(function (err) {
+            expect(executed).to.equal(false);
+            expect(err.state).to.equal("HY008");
+            stmt.cancel();
+        });
+
+        expect(stmt.queueDepth()).to.equal(1);
+        expect(stmt.cancelQueued()).to.equal(1);
+
+        var check = setInterval(function () {
+            if (executed) {
+                clearInterval(check);
+                done();
+            }
+        }, 100);
+    });
+
     afterEach(function () {
         stmt.free();
         conn.disconnect(conn.free.bind(conn));
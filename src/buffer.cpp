@@ -1,17 +1,51 @@
 #include "buffer.hpp"
-#include <ctime>
+#include "timestamp.hpp"
+#include "numeric.hpp"
+#include <climits>
+#include <cmath>
+#include <cstring>
 
 namespace Eos {
     namespace Buffers {
-        bool Allocate(SQLLEN length, SQLPOINTER& buffer, Handle<Object>& handle) {
-            handle = JSBuffer::New(length);
+        namespace {
+            // Numbers and numeric strings (e.g. "12345678901234567.89"), which are
+            // parsed exactly rather than going through a double.
+            bool NumericFromJS(Handle<Value> jsValue, SQLSMALLINT decimalDigits, SQL_NUMERIC_STRUCT& value) {
+                if (jsValue->IsNumber() ? !std::isfinite(jsValue->NumberValue()) : !jsValue->IsString())
+                    return false;
+
+                auto str = jsValue->ToString();
+                char chars[256];
+                if (str.IsEmpty() || str->Utf8Length() >= static_cast<int>(sizeof(chars)))
+                    return false;
+
+                auto length = str->WriteUtf8(chars, sizeof(chars), nullptr, String::NO_NULL_TERMINATION);
+                return Numerics::Parse(chars, length, 0, static_cast<SQLSCHAR>(decimalDigits), value);
+            }
+
+            bool BigIntFromJS(Handle<Value> jsValue, SQLBIGINT& value) {
+                if (jsValue->IsNumber()) {
+                    auto number = jsValue->NumberValue();
+                    if (!(number >= -9223372036854775808.0 && number < 9223372036854775808.0) || number != std::floor(number))
+                        return false;
+
+                    value = static_cast<SQLBIGINT>(number);
+                    return true;
+                }
+
+                SQL_NUMERIC_STRUCT numeric;
+                return NumericFromJS(jsValue, 0, numeric) && Numerics::ToBigInt(numeric, value);
+            }
+        }
+
+        bool Allocate(BufferPool* pool, SQLLEN length, SQLPOINTER& buffer, Handle<Object>& handle) {
+            handle = pool->NewBuffer(length, buffer);
             if (handle.IsEmpty()) {
                 EOS_DEBUG(L"Failed to allocate parameter buffer\n");
                 buffer = nullptr;
                 return false;
             }
 
-            JSBuffer::Unwrap(handle, buffer, length);
             return true;
         }
 
@@ -19,13 +53,15 @@ namespace Eos {
             switch(cType) {
             case SQL_C_SLONG: return sizeof(SQLINTEGER);
             case SQL_C_DOUBLE: return sizeof(SQLDOUBLE);
+            case SQL_C_SBIGINT: return sizeof(SQLBIGINT);
+            case SQL_C_NUMERIC: return sizeof(SQL_NUMERIC_STRUCT);
             case SQL_C_BIT: return sizeof(bool);
             case SQL_C_TYPE_TIMESTAMP: return sizeof(SQL_TIMESTAMP_STRUCT);
             default: return 0;
             }
         }
 
-        SQLLEN FillInputBuffer(SQLSMALLINT cType, Handle<Value> jsValue, SQLPOINTER buffer, SQLLEN length) {
+        SQLLEN FillInputBuffer(SQLSMALLINT cType, Handle<Value> jsValue, SQLPOINTER buffer, SQLLEN length, SQLSMALLINT decimalDigits) {
             switch(cType) {
             case SQL_C_SLONG:
                 *reinterpret_cast<SQLINTEGER*>(buffer) = jsValue->IntegerValue();
@@ -35,50 +71,72 @@ namespace Eos {
                 *reinterpret_cast<SQLDOUBLE*>(buffer) = jsValue->NumberValue();
                 return sizeof(SQLDOUBLE);
 
+            case SQL_C_SBIGINT:
+                if (!BigIntFromJS(jsValue, *reinterpret_cast<SQLBIGINT*>(buffer)))
+                    return 0;
+                return sizeof(SQLBIGINT);
+
+            case SQL_C_NUMERIC:
+                if (!NumericFromJS(jsValue, decimalDigits, *reinterpret_cast<SQL_NUMERIC_STRUCT*>(buffer)))
+                    return 0;
+                return sizeof(SQL_NUMERIC_STRUCT);
+
             case SQL_C_BIT:
                 *reinterpret_cast<bool*>(buffer) = jsValue->BooleanValue();
                 return sizeof(bool);
 
             case SQL_C_TYPE_TIMESTAMP:
-                if (!jsValue->IsDate())
+                // Dates, or numbers of milliseconds since the epoch, as UTC
+                if (!jsValue->IsDate() && !jsValue->IsNumber())
                     return 0;
 
-                {
-                    long jsTime = static_cast<long>(jsValue.As<Date>()->NumberValue());
-                    time_t time = jsTime;
-
-                    tm tm = *gmtime(&time);
-                    auto ts = reinterpret_cast<SQL_TIMESTAMP_STRUCT*>(buffer);
-                    ts->year = tm.tm_year + 1900;
-                    ts->month = tm.tm_mon + 1;
-                    ts->day = tm.tm_mday;
-                    ts->hour = tm.tm_hour;
-                    ts->minute = tm.tm_min;
-                    ts->second = tm.tm_sec;
-                    ts->fraction = (jsTime % 1000) * 100;
-                    return sizeof(*ts);
-                }
+                if (!Timestamps::FromEpochMilliseconds(jsValue->NumberValue(), *reinterpret_cast<SQL_TIMESTAMP_STRUCT*>(buffer)))
+                    return 0;
 
+                return sizeof(SQL_TIMESTAMP_STRUCT);
+
+            // V8 transcodes strings straight into the parameter's buffer, without
+            // creating a temporary copy first. WriteUtf8 never writes part of a
+            // character when the buffer is too small.
             case SQL_C_CHAR:
                 {
-                    String::Utf8Value val(jsValue);
-                    if (!*val)
+                    auto str = jsValue->ToString();
+                    if (str.IsEmpty())
                         return false;
 
-                    auto chars = min<size_t>(val.length(), length);
-                    strncpy(reinterpret_cast<char*>(buffer), *val, chars); 
-                    return chars;
+                    return str->WriteUtf8(
+                        reinterpret_cast<char*>(buffer), 
+                        static_cast<int>(min<SQLLEN>(length, INT_MAX)), 
+                        nullptr, 
+                        String::NO_NULL_TERMINATION);
                 }
 
             case SQL_C_WCHAR:
                 {
-                    WStringValue val(jsValue);
-                    if (!*val)
+                    auto str = jsValue->ToString();
+                    if (str.IsEmpty())
                         return false;
 
-                    auto chars = min<size_t>(val.length(), length / sizeof(**val));
-		            memcpy(buffer, *val, chars * sizeof(SQLWCHAR));
-                    return chars * sizeof(**val);
+                    auto chars = str->Write(
+                        reinterpret_cast<uint16_t*>(buffer), 
+                        0, 
+                        static_cast<int>(min<SQLLEN>(length / sizeof(SQLWCHAR), INT_MAX)), 
+                        String::NO_NULL_TERMINATION);
+                    return chars * sizeof(SQLWCHAR);
+                }
+
+            case SQL_C_BINARY:
+                {
+                    SQLPOINTER data;
+                    SQLLEN dataLength;
+                    if (!Buffer::HasInstance(jsValue) && !JSBuffer::HasInstance(jsValue))
+                        return 0;
+                    if (JSBuffer::Unwrap(jsValue.As<Object>(), data, dataLength))
+                        return 0;
+
+                    auto copied = min(length, dataLength);
+                    memcpy(buffer, data, copied);
+                    return copied;
                 }
 
             default: 
@@ -86,54 +144,64 @@ namespace Eos {
             }
         }
 
-        bool AllocateBoundInputParameter(SQLSMALLINT cType, Handle<Value> jsValue, SQLPOINTER& buffer, SQLLEN& length, Handle<Object>& handle) {
+        bool AllocateBoundInputParameter(BufferPool* pool, SQLSMALLINT cType, Handle<Value> jsValue, SQLPOINTER& buffer, SQLLEN& length, Handle<Object>& handle, SQLSMALLINT decimalDigits) {
             switch (cType) {
             case SQL_C_SLONG:
-                if(!AllocatePrimitive<SQLINTEGER>(static_cast<SQLINTEGER>(jsValue->IntegerValue()), buffer, handle))
+                if(!AllocatePrimitive<SQLINTEGER>(pool, static_cast<SQLINTEGER>(jsValue->IntegerValue()), buffer, handle))
                     return false;
                 length = sizeof(SQLINTEGER);
                 return true;
 
             case SQL_C_DOUBLE:
-                if(!AllocatePrimitive<SQLDOUBLE>(jsValue->NumberValue(), buffer, handle))
+                if(!AllocatePrimitive<SQLDOUBLE>(pool, jsValue->NumberValue(), buffer, handle))
                     return false;
                 length = sizeof(SQLDOUBLE);
                 return true;
 
+            case SQL_C_SBIGINT: {
+                SQLBIGINT value;
+                if (!BigIntFromJS(jsValue, value) || !AllocatePrimitive<SQLBIGINT>(pool, value, buffer, handle))
+                    return false;
+                length = sizeof(SQLBIGINT);
+                return true;
+            }
+
+            case SQL_C_NUMERIC: {
+                SQL_NUMERIC_STRUCT value;
+                if (!NumericFromJS(jsValue, decimalDigits, value) || !AllocatePrimitive<SQL_NUMERIC_STRUCT>(pool, value, buffer, handle))
+                    return false;
+                length = sizeof(SQL_NUMERIC_STRUCT);
+                return true;
+            }
+
             case SQL_C_BIT:
-                if(!AllocatePrimitive<bool>(jsValue->BooleanValue(), buffer, handle))
+                if(!AllocatePrimitive<bool>(pool, jsValue->BooleanValue(), buffer, handle))
                     return false;
                 length = sizeof(bool);
                 return true;
 
             case SQL_C_TYPE_TIMESTAMP:
-                if (jsValue->IsDate()) {
-                    long jsTime = static_cast<long>(jsValue.As<Date>()->NumberValue());
-                    time_t time = jsTime;
-
-                    tm tm = *gmtime(&time);
+                if (jsValue->IsDate() || jsValue->IsNumber()) {
                     SQL_TIMESTAMP_STRUCT ts;
-                    ts.year = tm.tm_year + 1900;
-                    ts.month = tm.tm_mon + 1;
-                    ts.day = tm.tm_mday;
-                    ts.hour = tm.tm_hour;
-                    ts.minute = tm.tm_min;
-                    ts.second = tm.tm_sec;
-                    ts.fraction = (jsTime % 1000) * 100;
-
-                    if (!AllocatePrimitive<SQL_TIMESTAMP_STRUCT>(ts, buffer, handle))
+                    if (!Timestamps::FromEpochMilliseconds(jsValue->NumberValue(), ts))
+                        return false;
+
+                    if (!AllocatePrimitive<SQL_TIMESTAMP_STRUCT>(pool, ts, buffer, handle))
                         return false;
+                    length = sizeof(SQL_TIMESTAMP_STRUCT);
                 } else {
                     return false;
                 }
                 return true;
 
+            // Strings are written straight into pooled memory by V8 (see FillInputBuffer).
             case SQL_C_CHAR:
                 if (jsValue->IsString()) {
-                    handle = JSBuffer::New(jsValue.As<String>(), NanNew<String>("utf8"));
-                    if (handle.IsEmpty())
+                    auto str = jsValue.As<String>();
+                    length = str->Utf8Length();
+                    if (!Allocate(pool, length, buffer, handle))
                         return false;
-                    JSBuffer::Unwrap(handle, buffer, length);
+                    str->WriteUtf8(reinterpret_cast<char*>(buffer), static_cast<int>(length), nullptr, String::NO_NULL_TERMINATION);
                 } else {
                     return false; 
                 }
@@ -141,10 +209,11 @@ namespace Eos {
 
             case SQL_C_WCHAR:
                 if (jsValue->IsString()) {
-                    handle = JSBuffer::New(jsValue.As<String>(), NanNew<String>("ucs2"));
-                    if (handle.IsEmpty())
+                    auto str = jsValue.As<String>();
+                    length = str->Length() * sizeof(SQLWCHAR);
+                    if (!Allocate(pool, length, buffer, handle))
                         return false;
-                    JSBuffer::Unwrap(handle, buffer, length);
+                    str->Write(reinterpret_cast<uint16_t*>(buffer), 0, -1, String::NO_NULL_TERMINATION);
                 } else {
                     return false; 
                 }
@@ -166,18 +235,12 @@ namespace Eos {
             }
         }
 
-        bool AllocateOutputBuffer(SQLSMALLINT cType, SQLPOINTER& buffer, SQLLEN& length, Handle<Object>& handle) {
+        bool AllocateOutputBuffer(BufferPool* pool, SQLSMALLINT cType, SQLPOINTER& buffer, SQLLEN& length, Handle<Object>& handle) {
             length = GetDesiredBufferLength(cType);
             if (length <= 0)
                 return false;
 
-            handle = JSBuffer::New(length);
-            if(auto msg = JSBuffer::Unwrap(handle, buffer, length)) {
-                EOS_DEBUG(L"%hs\n", msg);
-                return false;
-            }
-
-            return true;
+            return Allocate(pool, length, buffer, handle);
         }
     }
 }
@@ -1,15 +1,18 @@
 #include "eos.hpp"
+#include "pool.hpp"
 
 namespace Eos {
     namespace Buffers {
+        // Allocates a Buffer whose memory is borrowed from the pool.
         bool Allocate(
+            BufferPool* pool,
             SQLLEN length,
             SQLPOINTER& buffer,
             Handle<Object>& handle);
 
         template<class T>
-        bool AllocatePrimitive(const T& value, SQLPOINTER& buffer, Handle<Object>& handle) {
-            if (!Allocate(sizeof(T), buffer, handle))
+        bool AllocatePrimitive(BufferPool* pool, const T& value, SQLPOINTER& buffer, Handle<Object>& handle) {
+            if (!Allocate(pool, sizeof(T), buffer, handle))
                 return false;
 
             *reinterpret_cast<T*>(buffer) = value;
@@ -19,18 +22,23 @@ namespace Eos {
         SQLLEN GetDesiredBufferLength(
             SQLSMALLINT cType);
 
+        // decimalDigits is the scale of SQL_C_NUMERIC values.
         SQLLEN FillInputBuffer(
             SQLSMALLINT cType,
             Handle<Value> jsValue,
-            SQLPOINTER buffer, SQLLEN length);
+            SQLPOINTER buffer, SQLLEN length,
+            SQLSMALLINT decimalDigits = 0);
 
         bool AllocateBoundInputParameter(
+            BufferPool* pool,
             SQLSMALLINT cType,
             Handle<Value> jsValue,
             SQLPOINTER& buffer, SQLLEN& length,
-            Handle<Object>& handle);
+            Handle<Object>& handle,
+            SQLSMALLINT decimalDigits = 0);
 
         bool AllocateOutputBuffer(
+            BufferPool* pool,
             SQLSMALLINT cType, 
             SQLPOINTER& buffer, SQLLEN& length,
             Handle<Object>& handle);
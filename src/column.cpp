@@ -0,0 +1,123 @@
+#include "column.hpp"
+#include "buffer.hpp"
+
+using namespace Eos;
+using namespace Eos::Buffers;
+
+Persistent<FunctionTemplate> Column::constructor_;
+
+void Column::Init(Handle<Object> exports) {
+    NanAssignPersistent(constructor_, NanNew<FunctionTemplate>());
+    Constructor()->SetClassName(NanSymbol("Column"));
+    Constructor()->InstanceTemplate()->SetInternalFieldCount(1);
+
+    EOS_SET_GETTER(Constructor(), "value", Column, GetValue);
+    EOS_SET_GETTER(Constructor(), "bytesInBuffer", Column, GetBytesInBuffer);
+    EOS_SET_GETTER(Constructor(), "buffer", Column, GetBuffer);
+    EOS_SET_GETTER(Constructor(), "bufferLength", Column, GetBufferLength);
+    EOS_SET_GETTER(Constructor(), "index", Column, GetIndex);
+}
+
+Column::Column
+    ( SQLUSMALLINT columnNumber
+    , SQLSMALLINT sqlType
+    , SQLSMALLINT cType
+    , void* buffer
+    , SQLLEN length
+    , Handle<Object> bufferObject
+    )
+    : columnNumber_(columnNumber)
+    , sqlType_(sqlType)
+    , cType_(cType)
+    , buffer_(buffer)
+    , length_(length)
+    , indicator_(SQL_NULL_DATA)
+{
+    NanAssignPersistent(bufferObject_, bufferObject);
+
+    EOS_DEBUG_METHOD_FMT(L"buffer = 0x%p, length = %i", buffer, length);
+}
+
+const char* Column::Allocate(
+    BufferPool* pool,
+    SQLUSMALLINT columnNumber,
+    SQLSMALLINT sqlType,
+    SQLLEN bufferLength,
+    Handle<Object>& result)
+{
+    EOS_DEBUG_METHOD_FMT(L"column = %i, type = %i, length = %i", columnNumber, sqlType, bufferLength);
+
+    auto cType = GetCTypeForSQLType(sqlType);
+
+    // SQL_C_NUMERIC needs the scale of the result column in the ARD, which isn't
+    // known until the statement is executed, so bound columns use doubles.
+    if (cType == SQL_C_NUMERIC)
+        cType = SQL_C_DOUBLE;
+
+    // Fixed-length types always use their natural size
+    auto length = GetDesiredBufferLength(cType);
+    if (length == 0)
+        length = bufferLength;
+
+    if (length <= 0)
+        return "The buffer length must be positive";
+
+    SQLPOINTER buffer;
+    Handle<Object> handle;
+    if (!Buffers::Allocate(pool, length, buffer, handle))
+        return "Cannot allocate buffer for bound column";
+
+    auto column = new(nothrow) Column(columnNumber, sqlType, cType, buffer, length, handle);
+    if (!column)
+        return "Out of memory allocating column structure";
+
+    result = Constructor()->GetFunction()->NewInstance();
+    column->Wrap(result);
+
+    return nullptr;
+}
+
+NAN_GETTER(Column::GetBuffer) const {
+    EosMethodReturnValue(NanNew(bufferObject_));
+}
+
+NAN_GETTER(Column::GetBufferLength) const {
+    EosMethodReturnValue(NanNew<Integer>(length_));
+}
+
+NAN_GETTER(Column::GetIndex) const {
+    EosMethodReturnValue(NanNew<Integer>(columnNumber_));
+}
+
+NAN_GETTER(Column::GetBytesInBuffer) const {
+    if (indicator_ == SQL_NULL_DATA)
+        NanReturnNull();
+
+    if (indicator_ > length_ || indicator_ == SQL_NO_TOTAL)
+        EosMethodReturnValue(NanNew<Integer>(length_));
+
+    EosMethodReturnValue(NanNew<Integer>(indicator_));
+}
+
+NAN_GETTER(Column::GetValue) const {
+    if (indicator_ == SQL_NULL_DATA)
+        NanReturnNull();
+
+    if (cType_ == SQL_C_BINARY) {
+        if (indicator_ >= length_ || indicator_ == SQL_NO_TOTAL)
+            EosMethodReturnValue(NanNew(bufferObject_));
+        EosMethodReturnValue(JSBuffer::Slice(NanNew(bufferObject_), 0, indicator_));
+    }
+
+    // ConvertToJS expects at least one character
+    if ((cType_ == SQL_C_CHAR || cType_ == SQL_C_WCHAR) && indicator_ == 0)
+        EosMethodReturnValue(NanNew<String>(""));
+
+    EosMethodReturnValue(ConvertToJS(buffer_, indicator_, length_, cType_));
+}
+
+Column::~Column() {
+    EOS_DEBUG_METHOD();
+}
+
+namespace { ClassInitializer<Column> init; }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "eos.hpp"
+#include "pool.hpp"
+
+namespace Eos {
+    // A result column bound with SQLBindCol. The buffer is allocated once and
+    // filled in place by each successful fetch.
+    struct Column: ObjectWrap {
+        Column(SQLUSMALLINT columnNumber, SQLSMALLINT sqlType, SQLSMALLINT cType, void* buffer, SQLLEN length, Handle<Object> bufferObject);
+        ~Column();
+
+        static void Init(Handle<Object> exports);
+
+        NAN_GETTER(GetValue) const;
+        NAN_GETTER(GetBytesInBuffer) const;
+        NAN_GETTER(GetBuffer) const;
+        NAN_GETTER(GetBufferLength) const;
+        NAN_GETTER(GetIndex) const;
+
+    public:
+
+        static const char* Allocate(
+            BufferPool* pool,
+            SQLUSMALLINT columnNumber,
+            SQLSMALLINT sqlType,
+            SQLLEN bufferLength,
+            Handle<Object>& result);
+
+        static Column* Unwrap(Handle<Object> obj) {
+            return ObjectWrap::Unwrap<Column>(obj);
+        }
+
+        void* Buffer() const throw() { return buffer_; }
+        SQLLEN Length() const throw() { return length_; }
+
+        SQLUSMALLINT ColumnNumber() const throw() { return columnNumber_; }
+        SQLSMALLINT SQLType() const throw() { return sqlType_; }
+        SQLSMALLINT CType() const throw() { return cType_; }
+
+        SQLLEN& Indicator() throw() { return indicator_; }
+
+        static Handle<FunctionTemplate> Constructor() { return NanNew(constructor_); }
+
+    private:
+        static Persistent<FunctionTemplate> constructor_;
+
+        SQLSMALLINT sqlType_, cType_;
+        SQLUSMALLINT columnNumber_;
+
+        void* buffer_;
+        SQLLEN length_, indicator_;
+
+        Persistent<Object> bufferObject_;
+    };
+}
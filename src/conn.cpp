@@ -1,8 +1,15 @@
 #include "conn.hpp"
 #include "stmt.hpp"
+#include "workers.hpp"
 
 using namespace Eos;
 
+// From the SQL Server driver's header (msodbcsql.h)
+#if !defined(SQL_COPT_SS_RESET_CONNECTION)
+#define SQL_COPT_SS_RESET_CONNECTION 1232
+#define SQL_RESET_CONNECTION_YES 1
+#endif
+
 Persistent<FunctionTemplate> Connection::constructor_;
 
 void Connection::Init(Handle<Object> exports) {
@@ -17,17 +24,107 @@ void Connection::Init(Handle<Object> exports) {
     EOS_SET_METHOD(Constructor(), "newStatement", Connection, NewStatement, sig0);
     EOS_SET_METHOD(Constructor(), "nativeSql", Connection, NativeSql, sig0);
     EOS_SET_METHOD(Constructor(), "disconnect", Connection, Disconnect, sig0);
+    EOS_SET_METHOD(Constructor(), "metadataCacheStats", Connection, MetadataCacheStats, sig0);
+    EOS_SET_METHOD(Constructor(), "setMetadataCacheSize", Connection, SetMetadataCacheSize, sig0);
+    EOS_SET_METHOD(Constructor(), "clearMetadataCache", Connection, ClearMetadataCache, sig0);
+    EOS_SET_METHOD(Constructor(), "isDead", Connection, IsDead, sig0);
+    EOS_SET_METHOD(Constructor(), "resetSession", Connection, ResetSession, sig0);
+    EOS_SET_METHOD(Constructor(), "statementHandleCacheStats", Connection, StatementHandleCacheStats, sig0);
+    EOS_SET_METHOD(Constructor(), "setStatementHandleCacheSize", Connection, SetStatementHandleCacheSize, sig0);
+
+    // Exported so that lib/ can add methods written in JavaScript
+    exports->Set(NanSymbol("Connection"), Constructor()->GetFunction(), ReadOnly);
 }
 
 Connection::Connection(Eos::Environment* environment, SQLHDBC hDbc EOS_ASYNC_ONLY_ARG(HANDLE hEvent))
-    : environment_(environment)
-    , EosHandle(SQL_HANDLE_DBC, hDbc EOS_ASYNC_ONLY_ARG(hEvent))
+    : EosHandle(SQL_HANDLE_DBC, hDbc EOS_ASYNC_ONLY_ARG(hEvent))
+    , idleStatementCapacity_(DefaultIdleStatementCapacity)
+    , generation_(0)
+    , disconnecting_(0)
+    , statementsReused_(0)
+    , statementsRecycled_(0)
+    , environment_(environment)
+    , pool_(environment->Pool())
 {
     EOS_DEBUG_METHOD();
+
+    pool_->AddRef();
 }
 
 Connection::~Connection() {
     EOS_DEBUG_METHOD();
+
+    // Before the connection handle itself is freed
+    FreeIdleStatements(0);
+
+    WorkerPool::Unpin(this);
+    pool_->Release();
+}
+
+bool Connection::TakeStatementHandle(SQLHSTMT& hStmt EOS_ASYNC_ONLY_ARG(HANDLE& hEvent)) {
+    if (idleStatements_.empty())
+        return false;
+
+    auto& idle = idleStatements_.back();
+    hStmt = idle.hStmt;
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    hEvent = idle.hEvent;
+#endif
+    idleStatements_.pop_back();
+
+    statementsReused_++;
+    return true;
+}
+
+void Connection::ReturnStatementHandle(SQLHSTMT hStmt EOS_ASYNC_ONLY_ARG(HANDLE hEvent)) {
+    IdleStatement idle;
+    idle.hStmt = hStmt;
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    idle.hEvent = hEvent;
+#endif
+
+    idleStatements_.push_back(idle);
+    statementsRecycled_++;
+
+    FreeIdleStatements(idleStatementCapacity_);
+}
+
+// Frees the least recently returned handles until there are at most keep.
+void Connection::FreeIdleStatements(size_t keep) {
+    if (idleStatements_.size() <= keep)
+        return;
+
+    auto excess = idleStatements_.size() - keep;
+    for (size_t i = 0; i < excess; i++) {
+        SQLFreeHandle(SQL_HANDLE_STMT, idleStatements_[i].hStmt);
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+        if (idleStatements_[i].hEvent)
+            CloseHandle(idleStatements_[i].hEvent);
+#endif
+    }
+
+    idleStatements_.erase(idleStatements_.begin(), idleStatements_.begin() + excess);
+}
+
+void Connection::Disconnected() {
+    EOS_DEBUG_METHOD();
+
+    // SQLDisconnect has freed the handles already
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    for (size_t i = 0; i < idleStatements_.size(); i++)
+        if (idleStatements_[i].hEvent)
+            CloseHandle(idleStatements_[i].hEvent);
+#endif
+    idleStatements_.clear();
+
+    generation_++;
+
+    // The connection may reconnect to a different database, where the same
+    // SQL describes differently
+    metadataCache_.Clear();
+
+    // A pinned thread is started again if the connection reconnects
+    WorkerPool::Unpin(this);
 }
 
 NAN_METHOD(Connection::New) {
@@ -153,6 +250,37 @@ NAN_METHOD(Connection::NativeSql) {
     }
 }
 
+NAN_METHOD(Connection::MetadataCacheStats) {
+    EOS_DEBUG_METHOD();
+
+    EosMethodReturnValue(metadataCache_.Stats());
+}
+
+NAN_METHOD(Connection::SetMetadataCacheSize) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1 || !args[0]->IsUint32())
+        return NanThrowTypeError("The cache size must be a non-negative integer");
+
+    metadataCache_.SetCapacity(args[0]->Uint32Value());
+    NanReturnUndefined();
+}
+
+NAN_METHOD(Connection::ClearMetadataCache) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1 || args[0]->IsUndefined()) {
+        metadataCache_.Clear();
+        NanReturnUndefined();
+    }
+
+    if (!args[0]->IsString())
+        return NanThrowTypeError("The 1st argument should be the SQL of the statement to forget");
+
+    WStringValue sql(args[0]);
+    EosMethodReturnValue(NanNew<Boolean>(metadataCache_.Remove(*sql, sql.length())));
+}
+
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
 void Connection::DisableAsynchronousNotifications() {
     EOS_DEBUG_METHOD();
@@ -180,3 +308,51 @@ void Connection::DisableAsynchronousNotifications() {
 #endif
 
 namespace { ClassInitializer<Connection> ci; }
+
+// SQL_ATTR_CONNECTION_DEAD reports the state of the connection as of the last
+// call which used it, without a round trip to the server.
+NAN_METHOD(Connection::IsDead) {
+    EOS_DEBUG_METHOD();
+
+    SQLUINTEGER dead = SQL_CD_FALSE;
+    if (!SQL_SUCCEEDED(SQLGetConnectAttrW(GetHandle(), SQL_ATTR_CONNECTION_DEAD, &dead, SQL_IS_UINTEGER, nullptr)))
+        return NanThrowError(GetLastError());
+
+    EosMethodReturnValue(dead == SQL_CD_TRUE ? NanTrue() : NanFalse());
+}
+
+// Asks the driver to reset the session (rolling back any open transaction,
+// and resetting SET options, temporary tables and so on) before the next
+// statement runs, as its own connection pooling does. Only the SQL Server
+// driver supports this; returns false for other drivers.
+NAN_METHOD(Connection::ResetSession) {
+    EOS_DEBUG_METHOD();
+
+    auto ret = SQLSetConnectAttrW(GetHandle(), SQL_COPT_SS_RESET_CONNECTION, (SQLPOINTER)SQL_RESET_CONNECTION_YES, SQL_IS_INTEGER);
+
+    EosMethodReturnValue(SQL_SUCCEEDED(ret) ? NanTrue() : NanFalse());
+}
+
+NAN_METHOD(Connection::StatementHandleCacheStats) {
+    EOS_DEBUG_METHOD();
+
+    auto stats = NanNew<Object>();
+    stats->Set(NanSymbol("idle"), NanNew<Number>(static_cast<double>(idleStatements_.size())));
+    stats->Set(NanSymbol("capacity"), NanNew<Number>(static_cast<double>(idleStatementCapacity_)));
+    stats->Set(NanSymbol("reused"), NanNew<Number>(statementsReused_));
+    stats->Set(NanSymbol("recycled"), NanNew<Number>(statementsRecycled_));
+
+    EosMethodReturnValue(stats);
+}
+
+NAN_METHOD(Connection::SetStatementHandleCacheSize) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1 || !args[0]->IsUint32())
+        return NanThrowTypeError("The cache size must be a non-negative integer");
+
+    idleStatementCapacity_ = args[0]->Uint32Value();
+    FreeIdleStatements(idleStatementCapacity_);
+
+    NanReturnUndefined();
+}
@@ -13,10 +13,29 @@ namespace Eos {
                 return NanError("Too few arguments");
 
             (new DisconnectOperation())->Wrap(args.Holder());
+            owner->DisconnectBegun();
 
             EOS_OPERATION_CONSTRUCTOR_RETURN();
         }
 
+        void CancelQueued(Handle<Value> error) {
+            Owner()->DisconnectEnded();
+            Operation<Connection, DisconnectOperation>::CancelQueued(error);
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            Owner()->DisconnectEnded();
+
+            if (!SQL_SUCCEEDED(ret))
+                return CallbackErrorOverride(ret);
+
+            Owner()->Disconnected();
+
+            MakeCallback(0, nullptr);
+        }
+
         SQLRETURN CallOverride() {
             return SQLDisconnect(
                 Owner()->GetHandle());
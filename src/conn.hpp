@@ -3,6 +3,7 @@
 #include "eos.hpp"
 #include "env.hpp"
 #include "handle.hpp"
+#include "metadata.hpp"
 
 namespace Eos {
     struct Connection : EosHandle {
@@ -22,14 +23,67 @@ namespace Eos {
         NAN_METHOD(NewStatement);
         NAN_METHOD(NativeSql);
         NAN_METHOD(Disconnect);
+        NAN_METHOD(MetadataCacheStats);
+        NAN_METHOD(SetMetadataCacheSize);
+        NAN_METHOD(ClearMetadataCache);
+        NAN_METHOD(IsDead);
+        NAN_METHOD(ResetSession);
+        NAN_METHOD(StatementHandleCacheStats);
+        NAN_METHOD(SetStatementHandleCacheSize);
 
     public:
         // Non-JS methods
         static Handle<FunctionTemplate> Constructor() { return NanNew(constructor_); }
         void DisableAsynchronousNotifications();
+        BufferPool* Pool() const { return pool_; }
+        MetadataCache& GetMetadataCache() { return metadataCache_; }
+
+        // Statement handles which have been reset (see Statement::ResetHandle)
+        // after being freed, kept for newStatement to reuse instead of
+        // allocating new ones. Main thread only.
+        bool TakeStatementHandle(SQLHSTMT& hStmt EOS_ASYNC_ONLY_ARG(HANDLE& hEvent));
+
+        // Keeps a reset statement handle if there is room, or else frees it.
+        void ReturnStatementHandle(SQLHSTMT hStmt EOS_ASYNC_ONLY_ARG(HANDLE hEvent));
+
+        // Whether freed statements can keep their handles for reuse at all.
+        bool CanRecycleStatementHandles() const { return IsValid() && idleStatementCapacity_ > 0; }
+
+        // Incremented when the connection is disconnected, which frees every
+        // statement handle. Handles from before then can't be reused.
+        unsigned int Generation() const { return generation_; }
+        void Disconnected();
+
+        // True while a disconnect is waiting in the queue or running, when
+        // SQLDisconnect may be freeing the idle statement handles on the
+        // thread pool, so no statement can be created.
+        bool IsDisconnecting() const { return disconnecting_ > 0; }
+        void DisconnectBegun() { disconnecting_++; }
+        void DisconnectEnded() { disconnecting_--; }
+
+        const void* WorkerAffinity() const { return this; }
+
+        static const size_t DefaultIdleStatementCapacity = 16;
 
     private:
+        struct IdleStatement {
+            SQLHSTMT hStmt;
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+            HANDLE hEvent;
+#endif
+        };
+
+        void FreeIdleStatements(size_t keep);
+
+        std::vector<IdleStatement> idleStatements_;
+        size_t idleStatementCapacity_;
+        unsigned int generation_;
+        unsigned int disconnecting_;
+        double statementsReused_, statementsRecycled_;
+
         Eos::Environment* environment_;
+        BufferPool* pool_;
+        MetadataCache metadataCache_;
         static Persistent<FunctionTemplate> constructor_;
     };
 }
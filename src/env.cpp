@@ -12,12 +12,14 @@ void Eos::Environment::Init(Handle<Object> exports) {
     EOS_SET_METHOD(Constructor(), "newConnection", Environment, NewConnection, sig0);
     EOS_SET_METHOD(Constructor(), "dataSources", Environment, DataSources, sig0);
     EOS_SET_METHOD(Constructor(), "drivers", Environment, Drivers, sig0);
+    EOS_SET_METHOD(Constructor(), "bufferPoolStats", Environment, BufferPoolStats, sig0);
 
     exports->Set(NanSymbol("Environment"), Constructor()->GetFunction(), ReadOnly);
 }
 
 Eos::Environment::Environment(SQLHENV hEnv) 
     : EosHandle(SQL_HANDLE_ENV, hEnv EOS_ASYNC_ONLY_ARG(nullptr)) 
+    , pool_(new BufferPool())
 {
     EOS_DEBUG_METHOD();
 }
@@ -156,8 +158,16 @@ NAN_METHOD(Eos::Environment::Drivers) {
     }
 }
 
+NAN_METHOD(Eos::Environment::BufferPoolStats) {
+    EOS_DEBUG_METHOD();
+
+    EosMethodReturnValue(pool_->Stats());
+}
+
 Eos::Environment::~Environment() {
     EOS_DEBUG_METHOD();
+
+    pool_->Release();
 }
 
 Persistent<FunctionTemplate> Eos::Environment::constructor_;
@@ -2,6 +2,7 @@
 
 #include "eos.hpp"
 #include "handle.hpp"
+#include "pool.hpp"
 
 namespace Eos {
     struct Environment: EosHandle {
@@ -16,12 +17,15 @@ namespace Eos {
         NAN_METHOD(NewConnection);
         NAN_METHOD(DataSources);
         NAN_METHOD(Drivers);
+        NAN_METHOD(BufferPoolStats);
 
     public:
         // Non-JS methods
         static Handle<FunctionTemplate> Constructor() { return NanNew(constructor_); }
+        BufferPool* Pool() const { return pool_; }
 
     private:
+        BufferPool* pool_;
         static Persistent<FunctionTemplate> constructor_;
     };
 }
\ No newline at end of file
@@ -1,11 +1,15 @@
 #include "eos.hpp"
 #include "handle.hpp"
 #include "operation.hpp"
+#include "timestamp.hpp"
+#include "numeric.hpp"
 
 #include "uv.h"
 #include <ctime>
 #include <climits>
+#include <cstring>
 #include <string>
+#include <vector>
 
 int EosMethodDebugger::depth = 0;
 
@@ -39,6 +43,12 @@ namespace Eos {
         NODE_DEFINE_CONSTANT(exports, SQL_PARAM_INPUT_OUTPUT_STREAM);
         NODE_DEFINE_CONSTANT(exports, SQL_PARAM_OUTPUT);
         NODE_DEFINE_CONSTANT(exports, SQL_PARAM_OUTPUT_STREAM);
+
+        NODE_DEFINE_CONSTANT(exports, SQL_PARAM_SUCCESS);
+        NODE_DEFINE_CONSTANT(exports, SQL_PARAM_SUCCESS_WITH_INFO);
+        NODE_DEFINE_CONSTANT(exports, SQL_PARAM_ERROR);
+        NODE_DEFINE_CONSTANT(exports, SQL_PARAM_UNUSED);
+        NODE_DEFINE_CONSTANT(exports, SQL_PARAM_DIAG_UNAVAILABLE);
         
         NODE_DEFINE_CONSTANT(exports, SQL_CHAR);
         NODE_DEFINE_CONSTANT(exports, SQL_VARCHAR);
@@ -503,21 +513,110 @@ namespace Eos {
             return OdbcError(resultMessage);
     }
 
+    void CallbackOnNextTick(Handle<Function> callback, int argc, Handle<Value>* argv) {
+        // process.nextTick(callback.bind(undefined, argv...))
+        std::vector<Handle<Value> > bindArgs(1, NanUndefined());
+        bindArgs.insert(bindArgs.end(), argv, argv + argc);
+
+        auto bind = callback->Get(NanSymbol("bind")).As<Function>();
+        Handle<Value> bound = bind->Call(callback, static_cast<int>(bindArgs.size()), &bindArgs[0]);
+
+        auto process = NanGetCurrentContext()->Global()->Get(NanSymbol("process")).As<Object>();
+        auto nextTick = process->Get(NanSymbol("nextTick")).As<Function>();
+        nextTick->Call(process, 1, &bound);
+    }
+
     Local<String> StringFromTChar(const SQLWCHAR* string, int length) {
+        if (length < 0)
+            length = static_cast<int>(sqlwcslen(string));
+
+        // V8 stores strings with no characters above 0xFF in half the space, so narrow
+        // them here where possible (V8 in node 0.10 can only be given ASCII this way).
+        const SQLWCHAR maxChar = IF_NODE_12(0xFF, 0x7F);
+
+        unsigned char stackBuffer[1024];
+        std::vector<unsigned char> heapBuffer;
+        auto narrow = stackBuffer;
+        if (static_cast<size_t>(length) > sizeof(stackBuffer)) {
+            heapBuffer.resize(length);
+            narrow = &heapBuffer[0];
+        }
+
+        if (length > 0 && sqlwcsnarrow(string, length, narrow, maxChar))
+            return NanNew<String>(reinterpret_cast<const uint8_t*>(narrow), length);
+
         return NanNew<String>(reinterpret_cast<const uint16_t*>(string), length);
     }
 
+    namespace {
+        // Owns the buffer behind an external string, until V8 disposes of it.
+        struct ExternalWString : String::ExternalStringResource {
+            ExternalWString(const SQLWCHAR* data, size_t length, const BufferOwnership& ownership)
+                : data_(reinterpret_cast<const uint16_t*>(data))
+                , length_(length)
+                , release_(ownership.release)
+                , context_(ownership.context)
+            {
+                NanAdjustExternalMemory(static_cast<int>(length_ * sizeof(uint16_t)));
+            }
+
+            ~ExternalWString() {
+                NanAdjustExternalMemory(-static_cast<int>(length_ * sizeof(uint16_t)));
+                release_(context_);
+            }
+
+            const uint16_t* data() const { return data_; }
+            size_t length() const { return length_; }
+
+        private:
+            const uint16_t* data_;
+            size_t length_;
+            void (*release_)(void*);
+            void* context_;
+        };
+
+        void DeleteCopy(void* copy) {
+            delete[] static_cast<SQLWCHAR*>(copy);
+        }
+    }
+
+    Local<String> StringFromTChar(const SQLWCHAR* string, size_t length, BufferOwnership* ownership) {
+        if (!ownership || length < ExternalStringThreshold || length > INT_MAX)
+            return StringFromTChar(string, static_cast<int>(length));
+
+        // A value which uses less than half of the buffer is copied, so that
+        // it doesn't keep much more memory alive than it needs
+        if (length * sizeof(SQLWCHAR) * 2 < ownership->size) {
+            auto copy = new(nothrow) SQLWCHAR[length];
+            if (!copy)
+                return StringFromTChar(string, static_cast<int>(length));
+
+            memcpy(copy, string, length * sizeof(SQLWCHAR));
+            BufferOwnership copied(&DeleteCopy, copy, length * sizeof(SQLWCHAR));
+            return NanNew<String>(new ExternalWString(copy, length, copied));
+        }
+
+        auto str = NanNew<String>(new ExternalWString(string, length, *ownership));
+        ownership->taken = true;
+        return str;
+    }
+
     
     SQLSMALLINT GetCTypeForSQLType(SQLSMALLINT sqlType) {
         switch(sqlType) {
             case SQL_INTEGER: case SQL_SMALLINT: case SQL_TINYINT:
                 return SQL_C_SLONG;
     
-            case SQL_NUMERIC: case SQL_DECIMAL: case SQL_BIGINT:
+            case SQL_BIGINT:
+                return SQL_C_SBIGINT;
+
+            case SQL_NUMERIC: case SQL_DECIMAL:
+                return SQL_C_NUMERIC;
+
             case SQL_FLOAT: case SQL_REAL: case SQL_DOUBLE:
                 return SQL_C_DOUBLE;
 
-            case SQL_DATETIME: case SQL_TIMESTAMP:
+            case SQL_DATETIME: case SQL_TIMESTAMP: case SQL_TYPE_TIMESTAMP:
                 return SQL_C_TYPE_TIMESTAMP;
 
             case SQL_BIT:
@@ -550,7 +649,35 @@ namespace Eos {
         return SQL_WCHAR;
     }
 
-    Handle<Value> ConvertToJS(SQLPOINTER buffer, SQLLEN indicator, SQLLEN bufferLength, SQLSMALLINT cType) {
+    Handle<Value> TimestampToJS(const SQL_TIMESTAMP_STRUCT& ts, TimestampMode mode) {
+        switch (mode) {
+        case TimestampNumber:
+            return NanNew<Number>(Timestamps::ToEpochMilliseconds(ts));
+
+        case TimestampUTCDate:
+            return NanNew<Date>(Timestamps::ToEpochMilliseconds(ts));
+
+        default: {
+            tm tm = ::tm();
+            tm.tm_year = ts.year - 1900;
+            tm.tm_mon = ts.month - 1;
+            tm.tm_mday = ts.day;
+            tm.tm_hour = ts.hour;
+            tm.tm_min = ts.minute;
+            tm.tm_sec = ts.second;
+            
+#if defined(WIN32)
+            return NanNew<Date>((double(mktime(&tm)) * 1000)
+                   + (ts.fraction / 1000000.0));
+#else
+            return NanNew<Date>((double(timelocal(&tm)) * 1000)
+                   + (ts.fraction / 1000000.0));
+#endif
+        }
+        }
+    }
+
+    Handle<Value> ConvertToJS(SQLPOINTER buffer, SQLLEN indicator, SQLLEN bufferLength, SQLSMALLINT cType, BufferOwnership* ownership, const ConversionOptions& options) {
         if (indicator == SQL_NO_TOTAL || indicator > bufferLength)
             indicator = bufferLength;
         
@@ -560,6 +687,12 @@ namespace Eos {
 
         case SQL_C_DOUBLE:
             return NanNew<Number>(*reinterpret_cast<SQLDOUBLE*>(buffer));
+
+        case SQL_C_SBIGINT:
+            return BigIntToJS(*reinterpret_cast<SQLBIGINT*>(buffer), options.numerics);
+
+        case SQL_C_NUMERIC:
+            return NumericToJS(*reinterpret_cast<SQL_NUMERIC_STRUCT*>(buffer), options.numerics);
         
         case SQL_C_BIT:
             return *reinterpret_cast<SQLCHAR*>(buffer) ? NanTrue() : NanFalse();
@@ -577,26 +710,10 @@ namespace Eos {
             assert(indicator >= sizeof(SQLWCHAR));
             if (indicator == bufferLength)
                 indicator -= sizeof(SQLWCHAR);
-            return StringFromTChar(reinterpret_cast<const SQLWCHAR*>(buffer), indicator / 2);
+            return StringFromTChar(reinterpret_cast<const SQLWCHAR*>(buffer), indicator / 2, ownership);
 
-        case SQL_C_TYPE_TIMESTAMP: {
-            auto& ts = *reinterpret_cast<SQL_TIMESTAMP_STRUCT*>(buffer);
-            tm tm = ::tm();
-            tm.tm_year = ts.year - 1900;
-            tm.tm_mon = ts.month - 1;
-            tm.tm_mday = ts.day;
-            tm.tm_hour = ts.hour;
-            tm.tm_min = ts.minute;
-            tm.tm_sec = ts.second;
-            
-#if defined(WIN32)
-        return NanNew<Date>((double(mktime(&tm)) * 1000)
-               + (ts.fraction / 1000000.0));
-#else
-        return NanNew<Date>((double(timelocal(&tm)) * 1000)
-               + (ts.fraction / 1000000.0));
-#endif
-        }
+        case SQL_C_TYPE_TIMESTAMP:
+            return TimestampToJS(*reinterpret_cast<SQL_TIMESTAMP_STRUCT*>(buffer), options.timestamps);
 
         default:
             return NanUndefined();
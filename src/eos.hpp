@@ -147,9 +147,34 @@ namespace Eos {
     Handle<Value> GetLastError(SQLSMALLINT handleType, SQLHANDLE handle);
 
     // Do type hackery to cast from const SQLWCHAR* to const uint16_t* to please V8's 
-    // String::New function.
+    // String::New function. Strings which fit in one byte per character are narrowed
+    // first, so that V8 creates a one-byte string.
     Local<String> StringFromTChar(const SQLWCHAR* string, int length = -1);
 
+    // Strings of at least this many characters are worth creating as external strings,
+    // rather than copying them into the V8 heap.
+    const size_t ExternalStringThreshold = 16384;
+
+    // A buffer which a string may take ownership of instead of copying it. If taken is
+    // set, the caller must not touch the buffer again: release(context) is called when
+    // the string is garbage collected. size is the size of the whole buffer in bytes.
+    struct BufferOwnership {
+        BufferOwnership(void (*release)(void* context), void* context, size_t size)
+            : release(release), context(context), size(size), taken(false) {}
+
+        void (*release)(void* context);
+        void* context;
+        size_t size;
+        bool taken;
+    };
+
+    // Creates a UTF-16 string, as an external string if it is at least
+    // ExternalStringThreshold characters long and the ownership can be taken. The
+    // string uses the buffer directly if the value fills at least half of it, or else
+    // a copy of exactly the value's size, so that a short value doesn't keep a big
+    // buffer alive.
+    Local<String> StringFromTChar(const SQLWCHAR* string, size_t length, BufferOwnership* ownership);
+
     // Node's SetPrototypeMethod doesn't set a v8::Signature, which doesn't help debugging. Not
     // setting a Signature on a prototype method of an ObjectWrap class can result in segfault
     // or assertion, if the method is .call()'d on an ObjectWrap which is not the correct type,
@@ -234,9 +259,48 @@ namespace Eos {
         static Persistent<Function> constructor_;
     };
 
+    // Calls callback(argv...) on the next tick, for results which are already
+    // available when they are asked for (callbacks should never be synchronous).
+    void CallbackOnNextTick(Handle<Function> callback, int argc, Handle<Value>* argv);
+
     SQLSMALLINT GetSQLType(Handle<Value> jsValue);
     SQLSMALLINT GetCTypeForSQLType(SQLSMALLINT sqlType);
-    Handle<Value> ConvertToJS(SQLPOINTER buffer, SQLLEN indicator, SQLLEN bufferLength, SQLSMALLINT targetCType);
+    // How SQL_C_TYPE_TIMESTAMP values are returned to JS (see Statement.setTimestampMode).
+    enum TimestampMode {
+        TimestampLocalDate, // A Date, taking the timestamp as local time (the default)
+        TimestampUTCDate,   // A Date, taking the timestamp as UTC
+        TimestampNumber     // Milliseconds since the epoch, taking the timestamp as UTC
+    };
+
+    Handle<Value> TimestampToJS(const SQL_TIMESTAMP_STRUCT& ts, TimestampMode mode);
+
+    // How SQL_C_NUMERIC and SQL_C_SBIGINT values are returned to JS (see Statement.setNumericMode).
+    enum NumericMode {
+        NumericNumber, // The nearest Number (the default)
+        NumericString  // The exact value as a decimal string
+    };
+
+    // How rows are returned by fetchRow, fetchRows and fetchRowsAhead (see Statement.setRowMode).
+    enum RowMode {
+        RowArray, // An array of values, in column order (the default)
+        RowObject // An object with a property for each column name
+    };
+
+    // The per-statement settings which affect how values are converted.
+    struct ConversionOptions {
+        ConversionOptions()
+            : timestamps(TimestampLocalDate)
+            , numerics(NumericNumber)
+            , rows(RowArray)
+        {
+        }
+
+        TimestampMode timestamps;
+        NumericMode numerics;
+        RowMode rows;
+    };
+
+    Handle<Value> ConvertToJS(SQLPOINTER buffer, SQLLEN indicator, SQLLEN bufferLength, SQLSMALLINT targetCType, BufferOwnership* ownership = nullptr, const ConversionOptions& options = ConversionOptions());
     
     template <typename T>
     inline Persistent<T> Persist(Handle<T> value) {
@@ -13,12 +13,16 @@ EosHandle::EosHandle(SQLSMALLINT handleType, const SQLHANDLE handle EOS_ASYNC_ON
     , hEvent_(hEvent)
     , hWait_(nullptr)
 #endif
+    , maxQueueDepth_(DefaultMaxQueueDepth)
+    , running_(false)
 {
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
     EOS_DEBUG_METHOD_FMT(L"handleType = %i, hEvent = 0x%p", handleType, hEvent);
 #else
     EOS_DEBUG_METHOD_FMT(L"handleType = %i", handleType);
 #endif
+
+    uv_mutex_init(&queueMutex_);
 }
 
 EosHandle::~EosHandle() {
@@ -26,8 +30,10 @@ EosHandle::~EosHandle() {
     
     // Ref() and Unref() should ensure this does not happen
     assert(operation_.IsEmpty() && "The handle should not be destructed while an operation is in progress");
+    assert(queued_.empty() && "Queued operations should keep the handle alive");
 
     FreeHandle();
+    uv_mutex_destroy(&queueMutex_);
     
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
     assert(!hWait_ && "The handle should not be destructed until Notify() "
@@ -53,6 +59,9 @@ void EosHandle::Init ( const char* className
 
     auto sig0 = NanNew<Signature>(ft);
     EOS_SET_METHOD(ft, "free", EosHandle, Free, sig0);
+    EOS_SET_METHOD(ft, "cancelQueued", EosHandle, CancelQueued, sig0);
+    EOS_SET_METHOD(ft, "setMaxQueueDepth", EosHandle, SetMaxQueueDepth, sig0);
+    EOS_SET_METHOD(ft, "queueDepth", EosHandle, QueueDepth, sig0);
 }
 
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
@@ -103,15 +112,31 @@ void EosHandle::NotifyThreadPool() {
 NAN_METHOD(EosHandle::Free) {
     EOS_DEBUG_METHOD_FMT(L"handleType = %i", handleType_);
 
-    auto inProgress = !operation_.IsEmpty();
+    Handle<Value> callback = NanUndefined();
+    if (args.Length() > 0 && args[0]->IsFunction())
+        callback = args[0];
+
+    if (FreeWhenStopped(callback))
+        NanReturnUndefined();
+
+    auto inProgress = !operation_.IsEmpty() || running_;
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
     if (hWait_)
         inProgress = true;
 #endif
 
+    if (IsBusy())
+        inProgress = true;
+
     if (inProgress)
         return NanThrowError("Cannot free the handle - an operation is in progress");
 
+    if (args.Length() > 0 && args[0]->IsFunction())
+        return FreeAsync(args);
+
+    if (Recycle())
+        NanReturnUndefined();
+
     auto ret = FreeHandle();
     if (!SQL_SUCCEEDED(ret))
         return NanThrowError(GetLastError());
@@ -119,6 +144,95 @@ NAN_METHOD(EosHandle::Free) {
     NanReturnUndefined();
 }
 
+NAN_METHOD(EosHandle::FreeAsync) {
+    EOS_DEBUG_METHOD_FMT(L"handleType = %i", handleType_);
+
+    return NanThrowError("This type of handle can only be freed synchronously");
+}
+
+IOperation* EosHandle::TakeQueuedOperation() {
+    IOperation* op = nullptr;
+
+    uv_mutex_lock(&queueMutex_);
+    if (!queued_.empty()) {
+        op = queued_.front();
+        queued_.pop_front();
+    }
+    uv_mutex_unlock(&queueMutex_);
+
+    return op;
+}
+
+size_t EosHandle::QueuedOperations() {
+    uv_mutex_lock(&queueMutex_);
+    auto count = queued_.size();
+    uv_mutex_unlock(&queueMutex_);
+
+    return count;
+}
+
+bool EosHandle::QueueOrRun(IOperation* op) {
+    if (!running_) {
+        running_ = true;
+        return true;
+    }
+
+    WorkerPool::Hold();
+
+    uv_mutex_lock(&queueMutex_);
+    queued_.push_back(op);
+    uv_mutex_unlock(&queueMutex_);
+
+    return false;
+}
+
+IOperation* EosHandle::OperationCompleted(bool chained) {
+    if (chained)
+        return nullptr;
+
+    auto next = TakeQueuedOperation();
+    if (!next)
+        running_ = false;
+
+    return next;
+}
+
+// Calls back every queued operation with an error, without running it. The
+// running operation (if any) is not affected.
+NAN_METHOD(EosHandle::CancelQueued) {
+    EOS_DEBUG_METHOD_FMT(L"handleType = %i", handleType_);
+
+    std::deque<IOperation*> cancelled;
+
+    uv_mutex_lock(&queueMutex_);
+    cancelled.swap(queued_);
+    uv_mutex_unlock(&queueMutex_);
+
+    for (auto it = cancelled.begin(); it != cancelled.end(); ++it) {
+        (*it)->CancelQueued(OdbcError(NanNew<String>("Operation canceled"), NanNew<String>("HY008")));
+        WorkerPool::Release();
+    }
+
+    NanReturnValue(NanNew<Integer>(static_cast<int32_t>(cancelled.size())));
+}
+
+NAN_METHOD(EosHandle::SetMaxQueueDepth) {
+    EOS_DEBUG_METHOD_FMT(L"handleType = %i", handleType_);
+
+    if (args.Length() < 1 || !args[0]->IsUint32())
+        return NanThrowTypeError("The maximum queue depth must be a non-negative integer");
+
+    maxQueueDepth_ = args[0]->Uint32Value();
+
+    NanReturnUndefined();
+}
+
+NAN_METHOD(EosHandle::QueueDepth) {
+    EOS_DEBUG_METHOD_FMT(L"handleType = %i", handleType_);
+
+    NanReturnValue(NanNew<Integer>(static_cast<int32_t>(QueuedOperations())));
+}
+
 SQLRETURN EosHandle::FreeHandle() {
     EOS_DEBUG_METHOD_FMT(L"handleType = %i", handleType_);
 
@@ -164,6 +278,38 @@ SQLRETURN EosHandle::FreeHandle() {
     return SQL_SUCCESS;
 }
 
+SQLHANDLE EosHandle::DetachHandle() {
+    EOS_DEBUG_METHOD_FMT(L"handleType = %i, handle = 0x%p", handleType_, sqlHandle_);
+
+    assert(operation_.IsEmpty() && "The handle should not be detached while an operation is in progress");
+
+    auto handle = sqlHandle_;
+    sqlHandle_ = SQL_NULL_HANDLE;
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    if (hEvent_) {
+        if(!CloseHandle(hEvent_))
+            EOS_DEBUG(L"Failed to close hEvent_\n");
+        hWait_ = nullptr;
+        hEvent_ = nullptr;
+    }
+#endif
+
+    return handle;
+}
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+SQLHANDLE EosHandle::DetachHandle(HANDLE& hEvent) {
+    EOS_DEBUG_METHOD_FMT(L"handleType = %i, handle = 0x%p", handleType_, sqlHandle_);
+
+    hEvent = hEvent_;
+    hEvent_ = nullptr;
+    hWait_ = nullptr;
+
+    return DetachHandle();
+}
+#endif
+
 #if defined(DEBUG)
 NAN_METHOD(EosHandle::GetActiveHandles) {
     NanScope();
@@ -4,6 +4,7 @@
 #include "operation.hpp"
 
 #include <uv.h>
+#include <deque>
 
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
 #define EOS_ASYNC_ONLY_ARG(x) , x
@@ -18,6 +19,10 @@ namespace Eos {
         ~EosHandle();
         
         NAN_METHOD(Free);
+
+        // free(callback) frees the handle on the thread pool instead, if the
+        // handle type supports it.
+        virtual NAN_METHOD(FreeAsync);
         SQLHANDLE GetHandle() const { return sqlHandle_; }
         SQLSMALLINT GetHandleType() const { return handleType_; }
         Handle<Value> GetLastError() { return Eos::GetLastError(handleType_, sqlHandle_); }
@@ -60,6 +65,32 @@ namespace Eos {
 
         void NotifyThreadPool();
 
+        // Operations started while another is running on the thread pool wait
+        // in a queue, and are started in order. Returns the next one and
+        // removes it from the queue, or returns nullptr. Thread safe.
+        IOperation* TakeQueuedOperation();
+
+        // Called on the main thread before the callback of an operation which
+        // went through the queue. Returns the next operation, to be started
+        // after the callback, unless the completed operation already started
+        // it (chained) or there isn't one.
+        IOperation* OperationCompleted(bool chained);
+
+        // True from when an operation is begun on the thread pool until the
+        // last one queued behind it is called back.
+        bool IsRunning() const { return running_; }
+
+        // Queues an operation which has been begun behind the running one,
+        // or marks the handle as running and returns true, in which case the
+        // caller starts it straight away.
+        bool QueueOrRun(IOperation* op);
+
+        NAN_METHOD(CancelQueued);
+        NAN_METHOD(SetMaxQueueDepth);
+        NAN_METHOD(QueueDepth);
+
+        static const size_t DefaultMaxQueueDepth = 64;
+
     protected:
         static void Init(
             const char* className, 
@@ -76,12 +107,23 @@ namespace Eos {
                 return NanThrowError("This handle is already busy.");
 #endif
 
+            if (IsBusy())
+                return NanThrowError("An operation is already in progress on this handle.");
+
             IOperation* currentOp = nullptr;
             if (!operation_.IsEmpty()) {
                 currentOp = ObjectWrap::Unwrap<IOperation>(NanNew(operation_));
                 return NanThrowError("An operation is already in progress on this handle.");
             }
 
+            // Checked before constructing the operation, since it can't be
+            // destroyed without having run
+            if (running_ && QueuedOperations() >= maxQueueDepth_) {
+                return maxQueueDepth_ == 0
+                    ? NanThrowError("An operation is already in progress on this handle.")
+                    : NanThrowError("Too many operations are queued on this handle.");
+            }
+
             auto op = TOp::Construct(argv).template As<Object>();
             if (op.IsEmpty())
                 NanReturnUndefined(); // Probably the constructor threw
@@ -92,12 +134,19 @@ namespace Eos {
                 NanReturnUndefined();
             }
 #endif
-            
-            ObjectWrap::Unwrap<TOp>(op)->RunOnThreadPool();
+
+            auto opPtr = ObjectWrap::Unwrap<TOp>(op);
+            opPtr->Sequence();
+            opPtr->Enqueue();
+
+            if (QueueOrRun(opPtr))
+                opPtr->StartQueued();
 
             NanReturnUndefined();
         }
 
+        size_t QueuedOperations();
+
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
         template <typename TOp>
         void RunAsync(Handle<Object> op) {
@@ -122,9 +171,37 @@ namespace Eos {
         }
 #endif
 
+        // True if the handle is being used by something other than a
+        // single operation (e.g. a statement which is reading ahead).
+        virtual bool IsBusy() const { return false; }
+
+        // Called by free() first. A handle which is busy but can be stopped
+        // (i.e. a statement which is reading ahead) arranges to be freed once
+        // it has stopped, and returns true. callback is undefined unless one
+        // was passed to free().
+        virtual bool FreeWhenStopped(Handle<Value> callback) { return false; }
+
+        // Identifies the connection whose worker thread runs this handle's
+        // operations when connections are pinned (see WorkerPool), or nullptr.
+        virtual const void* WorkerAffinity() const { return nullptr; }
+
         bool IsValid() const { return sqlHandle_ != SQL_NULL_HANDLE; }
         SQLRETURN FreeHandle();
 
+        // Called by free() before freeing the handle. Handle types which can
+        // be reused (i.e. statements) detach the handle and keep it, and
+        // return true.
+        virtual bool Recycle() { return false; }
+
+        // Gives up the ODBC handle, which the caller must then free (e.g. on
+        // the thread pool). This object is left as if it had been freed.
+        SQLHANDLE DetachHandle();
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+        // As above, but gives up the event handle too, instead of closing it.
+        SQLHANDLE DetachHandle(HANDLE& hEvent);
+#endif
+
     private:
         EosHandle(const EosHandle& other); // = delete;
         
@@ -133,6 +210,12 @@ namespace Eos {
 #endif
 
         Persistent<Object> operation_;
+
+        // Guards queued_, which the worker threads take from
+        uv_mutex_t queueMutex_;
+        std::deque<IOperation*> queued_;
+        size_t maxQueueDepth_;
+        bool running_;
         SQLHANDLE sqlHandle_;
         SQLSMALLINT handleType_; 
     };
@@ -0,0 +1,160 @@
+#include "metadata.hpp"
+
+using namespace Eos;
+
+ParameterDescription::ParameterDescription()
+    : dataType(SQL_UNKNOWN_TYPE)
+    , parameterSize(0)
+    , decimalDigits(0)
+    , nullable(SQL_NULLABLE_UNKNOWN)
+{
+}
+
+SQLRETURN ParameterDescription::Describe(SQLHSTMT hStmt, SQLUSMALLINT parameterNumber) {
+    EOS_DEBUG_METHOD_FMT(L"%hu", parameterNumber);
+
+    return SQLDescribeParam(
+        hStmt,
+        parameterNumber,
+        &dataType,
+        &parameterSize,
+        &decimalDigits,
+        &nullable);
+}
+
+StatementMetadata::StatementMetadata()
+    : parametersDescribed(false)
+    , refs_(1)
+{
+    EOS_DEBUG_METHOD();
+}
+
+SQLRETURN StatementMetadata::Describe(SQLHSTMT hStmt) {
+    EOS_DEBUG_METHOD();
+
+    SQLSMALLINT columnCount;
+    auto ret = SQLNumResultCols(hStmt, &columnCount);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    columns.resize(columnCount);
+    for (SQLSMALLINT i = 0; i < columnCount; i++) {
+        ret = columns[i].Describe(hStmt, i + 1);
+        if (!SQL_SUCCEEDED(ret))
+            return ret;
+    }
+
+    // Not every driver can describe parameters, which is not an error: the
+    // parameters just have to be bound with explicit sizes.
+    SQLSMALLINT parameterCount;
+    if (!SQL_SUCCEEDED(SQLNumParams(hStmt, &parameterCount)))
+        return SQL_SUCCESS;
+
+    parameters.resize(parameterCount);
+    for (SQLSMALLINT i = 0; i < parameterCount; i++) {
+        if (!SQL_SUCCEEDED(parameters[i].Describe(hStmt, i + 1))) {
+            parameters.clear();
+            return SQL_SUCCESS;
+        }
+    }
+
+    parametersDescribed = true;
+    return SQL_SUCCESS;
+}
+
+MetadataCache::MetadataCache()
+    : capacity_(DefaultCapacity)
+    , hits_(0)
+    , misses_(0)
+{
+    EOS_DEBUG_METHOD();
+}
+
+MetadataCache::~MetadataCache() {
+    EOS_DEBUG_METHOD();
+
+    Clear();
+}
+
+StatementMetadata* MetadataCache::Find(const SQLWCHAR* sql, size_t length) {
+    if (capacity_ == 0)
+        return nullptr;
+
+    auto it = entries_.find(Key(sql, sql + length));
+    if (it == entries_.end()) {
+        misses_++;
+        return nullptr;
+    }
+
+    hits_++;
+
+    // Move to the front of the usage list
+    usage_.splice(usage_.begin(), usage_, it->second.usage);
+    return it->second.metadata;
+}
+
+void MetadataCache::Insert(const SQLWCHAR* sql, size_t length, StatementMetadata* metadata) {
+    EOS_DEBUG_METHOD();
+
+    if (capacity_ == 0)
+        return;
+
+    Key key(sql, sql + length);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        metadata->AddRef();
+        it->second.metadata->Release();
+        it->second.metadata = metadata;
+        usage_.splice(usage_.begin(), usage_, it->second.usage);
+        return;
+    }
+
+    Evict(capacity_ - 1);
+
+    usage_.push_front(key);
+
+    Entry entry = { metadata, usage_.begin() };
+    entries_.insert(EntryMap::value_type(key, entry));
+    metadata->AddRef();
+}
+
+bool MetadataCache::Remove(const SQLWCHAR* sql, size_t length) {
+    auto it = entries_.find(Key(sql, sql + length));
+    if (it == entries_.end())
+        return false;
+
+    it->second.metadata->Release();
+    usage_.erase(it->second.usage);
+    entries_.erase(it);
+    return true;
+}
+
+void MetadataCache::Clear() {
+    Evict(0);
+}
+
+void MetadataCache::SetCapacity(size_t capacity) {
+    capacity_ = capacity;
+    Evict(capacity);
+}
+
+// Removes the least recently used entries until there are at most size.
+void MetadataCache::Evict(size_t size) {
+    while (entries_.size() > size) {
+        auto it = entries_.find(usage_.back());
+        assert(it != entries_.end());
+
+        it->second.metadata->Release();
+        entries_.erase(it);
+        usage_.pop_back();
+    }
+}
+
+Handle<Object> MetadataCache::Stats() const {
+    auto stats = NanNew<Object>();
+    stats->Set(NanSymbol("hits"), NanNew<Number>(hits_));
+    stats->Set(NanSymbol("misses"), NanNew<Number>(misses_));
+    stats->Set(NanSymbol("size"), NanNew<Number>(static_cast<double>(entries_.size())));
+    stats->Set(NanSymbol("capacity"), NanNew<Number>(static_cast<double>(capacity_)));
+    return stats;
+}
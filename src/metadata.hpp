@@ -0,0 +1,144 @@
+#pragma once
+
+#include "eos.hpp"
+#include "result.hpp"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace Eos {
+    // The information returned by SQLDescribeParam for a single parameter.
+    struct ParameterDescription {
+        ParameterDescription();
+
+        // Safe to call from the thread pool.
+        SQLRETURN Describe(SQLHSTMT hStmt, SQLUSMALLINT parameterNumber);
+
+        SQLSMALLINT dataType;
+        SQLULEN parameterSize;
+        SQLSMALLINT decimalDigits;
+        SQLSMALLINT nullable;
+    };
+
+    // The result columns and parameters of a prepared statement, captured
+    // once after SQLPrepare. Immutable once it has been described, so it can
+    // be read on the thread pool; the reference count is only touched on the
+    // main thread.
+    struct StatementMetadata {
+        StatementMetadata();
+
+        void AddRef() { refs_++; }
+        void Release() { if (--refs_ == 0) delete this; }
+
+        // Describes the columns of the first result set and, if the driver
+        // supports SQLDescribeParam, the parameters. Safe to call from the
+        // thread pool.
+        SQLRETURN Describe(SQLHSTMT hStmt);
+
+        std::vector<ColumnAttributes> columns;
+        std::vector<ParameterDescription> parameters;
+        bool parametersDescribed;
+
+    private:
+        ~StatementMetadata() {}
+        StatementMetadata(const StatementMetadata&); // = delete
+        void operator=(const StatementMetadata&); // = delete
+
+        int refs_;
+    };
+
+    // Holds a reference to statement metadata (if any) for as long as an
+    // operation needs it.
+    struct MetadataReference {
+        explicit MetadataReference(StatementMetadata* metadata = nullptr)
+            : metadata_(metadata)
+        {
+            if (metadata_)
+                metadata_->AddRef();
+        }
+
+        ~MetadataReference() {
+            if (metadata_)
+                metadata_->Release();
+        }
+
+        void Reset(StatementMetadata* metadata = nullptr) {
+            if (metadata)
+                metadata->AddRef();
+            if (metadata_)
+                metadata_->Release();
+            metadata_ = metadata;
+        }
+
+        // Takes over the caller's reference to metadata.
+        void Take(StatementMetadata* metadata) {
+            if (metadata_)
+                metadata_->Release();
+            metadata_ = metadata;
+        }
+
+        StatementMetadata* Get() const { return metadata_; }
+
+        // The described result columns, or nullptr if there is no metadata.
+        const std::vector<ColumnAttributes>* Columns() const {
+            return metadata_ ? &metadata_->columns : nullptr;
+        }
+
+    private:
+        MetadataReference(const MetadataReference&); // = delete
+        void operator=(const MetadataReference&); // = delete
+
+        StatementMetadata* metadata_;
+    };
+
+    // A least-recently-used cache of statement metadata, keyed by SQL text,
+    // so that statements which are prepared again and again don't have to be
+    // described again. Each connection has one. Main thread only.
+    struct MetadataCache {
+        MetadataCache();
+        ~MetadataCache();
+
+        // Returns the metadata for the given SQL (without adding a reference),
+        // or nullptr, and counts a hit or a miss.
+        StatementMetadata* Find(const SQLWCHAR* sql, size_t length);
+
+        // Adds or replaces the metadata for the given SQL, evicting the least
+        // recently used entry if the cache is full.
+        void Insert(const SQLWCHAR* sql, size_t length, StatementMetadata* metadata);
+
+        // Removes the entry for the given SQL; returns false if there was none.
+        bool Remove(const SQLWCHAR* sql, size_t length);
+        void Clear();
+
+        // A capacity of 0 turns the cache off.
+        void SetCapacity(size_t capacity);
+        size_t Capacity() const { return capacity_; }
+
+        // { hits, misses, size, capacity }
+        Handle<Object> Stats() const;
+
+        static const size_t DefaultCapacity = 500;
+
+    private:
+        MetadataCache(const MetadataCache&); // = delete
+        void operator=(const MetadataCache&); // = delete
+
+        typedef std::vector<SQLWCHAR> Key;
+        typedef std::list<Key> UsageList;
+
+        struct Entry {
+            StatementMetadata* metadata;
+            UsageList::iterator usage;
+        };
+
+        typedef std::map<Key, Entry> EntryMap;
+
+        void Evict(size_t size);
+
+        EntryMap entries_;
+        UsageList usage_; // Most recently used first
+        size_t capacity_;
+        double hits_, misses_;
+    };
+}
@@ -0,0 +1,376 @@
+#include "numeric.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace Eos;
+
+namespace {
+    // SQL_NUMERIC_STRUCT holds a 128-bit little-endian mantissa, which is
+    // worked on here as four 32-bit limbs (least significant first).
+    struct Mantissa {
+        uint32_t limbs[4];
+
+        explicit Mantissa(const SQLCHAR* val) {
+            for (int i = 0; i < 4; i++) {
+                limbs[i] = uint32_t(val[i * 4])
+                    | uint32_t(val[i * 4 + 1]) << 8
+                    | uint32_t(val[i * 4 + 2]) << 16
+                    | uint32_t(val[i * 4 + 3]) << 24;
+            }
+        }
+
+        Mantissa() {
+            limbs[0] = limbs[1] = limbs[2] = limbs[3] = 0;
+        }
+
+        void Store(SQLCHAR* val) const {
+            for (int i = 0; i < 16; i++)
+                val[i] = static_cast<SQLCHAR>(limbs[i / 4] >> (8 * (i % 4)));
+        }
+
+        bool IsZero() const {
+            return !(limbs[0] | limbs[1] | limbs[2] | limbs[3]);
+        }
+
+        bool FitsIn64() const {
+            return !(limbs[2] | limbs[3]);
+        }
+
+        uint64_t Low64() const {
+            return uint64_t(limbs[1]) << 32 | limbs[0];
+        }
+
+        // Divides by divisor in place and returns the remainder.
+        uint32_t DivMod(uint32_t divisor) {
+            uint64_t remainder = 0;
+            for (int i = 3; i >= 0; i--) {
+                auto current = remainder << 32 | limbs[i];
+                limbs[i] = static_cast<uint32_t>(current / divisor);
+                remainder = current % divisor;
+            }
+            return static_cast<uint32_t>(remainder);
+        }
+
+        // Multiplies by factor and adds addend. Returns false on overflow.
+        bool MulAdd(uint32_t factor, uint32_t addend) {
+            uint64_t carry = addend;
+            for (int i = 0; i < 4; i++) {
+                auto current = uint64_t(limbs[i]) * factor + carry;
+                limbs[i] = static_cast<uint32_t>(current);
+                carry = current >> 32;
+            }
+            return carry == 0;
+        }
+    };
+
+    // Writes the digits of value to the end of the buffer, returning a pointer
+    // to the first one. The buffer must have room for 39 digits.
+    char* FormatDigits(Mantissa value, char* end) {
+        auto p = end;
+        if (value.IsZero()) {
+            *--p = '0';
+            return p;
+        }
+
+        // Nine digits at a time while there are more than nine left
+        while (!value.FitsIn64()) {
+            auto chunk = value.DivMod(1000000000);
+            for (int i = 0; i < 9; i++, chunk /= 10)
+                *--p = static_cast<char>('0' + chunk % 10);
+        }
+
+        for (auto low = value.Low64(); low; low /= 10)
+            *--p = static_cast<char>('0' + low % 10);
+
+        return p;
+    }
+
+    const double PowersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+}
+
+int Numerics::Format(const SQL_NUMERIC_STRUCT& value, char* out) {
+    char digitBuffer[40];
+    auto digitsEnd = digitBuffer + sizeof(digitBuffer);
+
+    Mantissa mantissa(value.val);
+    auto digits = FormatDigits(mantissa, digitsEnd);
+    int digitCount = static_cast<int>(digitsEnd - digits);
+    int scale = value.scale;
+
+    auto p = out;
+    if (value.sign == 0 && !mantissa.IsZero())
+        *p++ = '-';
+
+    if (mantissa.IsZero() && scale <= 0) {
+        *p++ = '0';
+    } else if (scale <= 0) {
+        memcpy(p, digits, digitCount);
+        p += digitCount;
+        for (int i = 0; i < -scale; i++)
+            *p++ = '0';
+    } else if (digitCount <= scale) {
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = digitCount; i < scale; i++)
+            *p++ = '0';
+        memcpy(p, digits, digitCount);
+        p += digitCount;
+    } else {
+        memcpy(p, digits, digitCount - scale);
+        p += digitCount - scale;
+        *p++ = '.';
+        memcpy(p, digits + digitCount - scale, scale);
+        p += scale;
+    }
+
+    *p = 0;
+    return static_cast<int>(p - out);
+}
+
+int Numerics::Format(SQLBIGINT value, char* out) {
+    char digitBuffer[24];
+    auto end = digitBuffer + sizeof(digitBuffer);
+    auto p = end;
+
+    // Negate as unsigned, so that the most negative value works
+    auto magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+
+    auto q = out;
+    if (value < 0)
+        *q++ = '-';
+    memcpy(q, p, end - p);
+    q += end - p;
+    *q = 0;
+    return static_cast<int>(q - out);
+}
+
+double Numerics::ToDouble(const SQL_NUMERIC_STRUCT& value) {
+    Mantissa mantissa(value.val);
+    double sign = value.sign == 0 ? -1 : 1;
+
+    // Both operands are exact here, so the result is correctly rounded
+    if (mantissa.FitsIn64() && mantissa.Low64() <= (uint64_t(1) << 53)) {
+        auto m = static_cast<double>(mantissa.Low64());
+        if (value.scale >= 0 && value.scale <= 22)
+            return sign * (m / PowersOf10[value.scale]);
+        if (value.scale < 0 && value.scale >= -22)
+            return sign * (m * PowersOf10[-value.scale]);
+    }
+
+    char buffer[MaxFormattedLength];
+    Format(value, buffer);
+    return strtod(buffer, nullptr);
+}
+
+int Numerics::GetScale(const char* str, int length) {
+    auto p = str, end = str + length;
+
+    int scale = 0;
+    while (p < end && *p != '.' && *p != 'e' && *p != 'E')
+        p++;
+
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++)
+            scale++;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negativeExponent = *p++ == '-';
+
+        int e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (e > 10000)
+                break;
+            e = e * 10 + (*p - '0');
+        }
+        scale += negativeExponent ? e : -e;
+    }
+
+    return scale > 0 ? scale : 0;
+}
+
+bool Numerics::Parse(const char* str, int length, SQLCHAR precision, SQLSCHAR scale, SQL_NUMERIC_STRUCT& value) {
+    const int MaxDigits = 128;
+
+    auto p = str, end = str + length;
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t'))
+        end--;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    // The significant digits (without leading zeros), and the power of ten
+    // which the last of them is multiplied by.
+    char digits[MaxDigits];
+    int digitCount = 0, exponent = 0;
+    bool anyDigits = false, point = false;
+
+    for (; p < end; p++) {
+        if (*p == '.' && !point) {
+            point = true;
+        } else if (*p >= '0' && *p <= '9') {
+            anyDigits = true;
+            if (digitCount == 0 && *p == '0') {
+                if (point)
+                    exponent--;
+                continue;
+            }
+            if (digitCount == MaxDigits)
+                return false;
+            digits[digitCount++] = *p;
+            if (point)
+                exponent--;
+        } else {
+            break;
+        }
+    }
+
+    if (!anyDigits)
+        return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negativeExponent = *p++ == '-';
+
+        if (p == end)
+            return false;
+
+        int e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (e > 10000)
+                return false;
+            e = e * 10 + (*p - '0');
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+
+    if (p != end)
+        return false;
+
+    // Scale the digits to the requested scale, rounding half away from zero
+    int shift = exponent + scale;
+    bool roundUp = false;
+    if (shift < 0) {
+        auto kept = digitCount + shift;
+        if (kept < 0) {
+            digitCount = 0;
+        } else {
+            roundUp = digits[kept] >= '5';
+            digitCount = kept;
+        }
+        shift = 0;
+    }
+
+    if (digitCount + shift > 38 || digitCount + shift > (precision ? precision : 38))
+        return false;
+
+    Mantissa mantissa;
+    for (int i = 0; i < digitCount; i++)
+        mantissa.MulAdd(10, digits[i] - '0');
+    for (int i = 0; i < shift; i++)
+        mantissa.MulAdd(10, 0);
+    if (roundUp && !mantissa.MulAdd(1, 1))
+        return false;
+
+    // Rounding up can add a digit (e.g. 9.99 to 10.0)
+    if (roundUp) {
+        Mantissa check = mantissa;
+        int count = 0;
+        while (!check.IsZero()) {
+            check.DivMod(10);
+            count++;
+        }
+        if (count > (precision ? precision : 38))
+            return false;
+    }
+
+    memset(&value, 0, sizeof(value));
+    value.precision = precision ? precision : 38;
+    value.scale = scale;
+    value.sign = negative && !mantissa.IsZero() ? 0 : 1;
+    mantissa.Store(value.val);
+    return true;
+}
+
+bool Numerics::ToBigInt(const SQL_NUMERIC_STRUCT& value, SQLBIGINT& result) {
+    Mantissa mantissa(value.val);
+    if (value.scale != 0 || !mantissa.FitsIn64())
+        return false;
+
+    auto magnitude = mantissa.Low64();
+    if (value.sign == 0) {
+        if (magnitude > uint64_t(1) << 63)
+            return false;
+        result = static_cast<SQLBIGINT>(0 - magnitude);
+    } else {
+        if (magnitude >= uint64_t(1) << 63)
+            return false;
+        result = static_cast<SQLBIGINT>(magnitude);
+    }
+
+    return true;
+}
+
+SQLRETURN Numerics::SetDescriptor(
+    SQLHSTMT hStmt,
+    SQLINTEGER descriptor,
+    SQLUSMALLINT recordNumber,
+    SQLSMALLINT precision,
+    SQLSMALLINT scale,
+    SQLPOINTER data)
+{
+    SQLHDESC hDesc = SQL_NULL_HDESC;
+    auto ret = SQLGetStmtAttrW(hStmt, descriptor, &hDesc, 0, nullptr);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    // Setting the type resets the precision and scale, so it comes first; setting
+    // the data pointer last (re)binds the record and checks its consistency.
+    ret = SQLSetDescFieldW(hDesc, recordNumber, SQL_DESC_TYPE, (SQLPOINTER)SQL_C_NUMERIC, SQL_IS_SMALLINT);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLSetDescFieldW(hDesc, recordNumber, SQL_DESC_PRECISION, (SQLPOINTER)(intptr_t)precision, SQL_IS_SMALLINT);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLSetDescFieldW(hDesc, recordNumber, SQL_DESC_SCALE, (SQLPOINTER)(intptr_t)scale, SQL_IS_SMALLINT);
+    if (!SQL_SUCCEEDED(ret) || !data)
+        return ret;
+
+    return SQLSetDescFieldW(hDesc, recordNumber, SQL_DESC_DATA_PTR, data, SQL_IS_POINTER);
+}
+
+Handle<Value> Eos::NumericToJS(const SQL_NUMERIC_STRUCT& value, NumericMode mode) {
+    if (mode == NumericNumber)
+        return NanNew<Number>(Numerics::ToDouble(value));
+
+    char buffer[Numerics::MaxFormattedLength];
+    auto length = Numerics::Format(value, buffer);
+    return NanNew<String>(buffer, length);
+}
+
+Handle<Value> Eos::BigIntToJS(SQLBIGINT value, NumericMode mode) {
+    if (mode == NumericNumber)
+        return NanNew<Number>(static_cast<double>(value));
+
+    char buffer[Numerics::MaxFormattedLength];
+    auto length = Numerics::Format(value, buffer);
+    return NanNew<String>(buffer, length);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "eos.hpp"
+
+namespace Eos {
+    // Exact conversion of SQL_C_NUMERIC and SQL_C_SBIGINT values. None of these
+    // functions allocate memory.
+    namespace Numerics {
+        // Enough for a sign, "0.", 128 zeros (the largest scale) and 39 digits.
+        const int MaxFormattedLength = 176;
+
+        // Writes the decimal representation of value to out (which must have room for
+        // MaxFormattedLength characters) and returns the number of characters written.
+        int Format(const SQL_NUMERIC_STRUCT& value, char* out);
+        int Format(SQLBIGINT value, char* out);
+
+        // The nearest double to value.
+        double ToDouble(const SQL_NUMERIC_STRUCT& value);
+
+        // Parses a decimal number (e.g. "-123.4500" or "1e-3") into value with the
+        // given scale, rounding half away from zero if there are more digits after
+        // the point than that. Returns false if the string is not a number or the
+        // result does not fit in the given precision.
+        // A precision of 0 means the maximum (38).
+        bool Parse(const char* str, int length, SQLCHAR precision, SQLSCHAR scale, SQL_NUMERIC_STRUCT& value);
+
+        // The number of digits after the point of a decimal number (allowing for an
+        // exponent, so "1.25" and "125e-2" both have 2), i.e. the smallest scale
+        // which Parse can use without rounding it. Returns 0 if the string is not a
+        // number.
+        int GetScale(const char* str, int length);
+
+        // Returns false unless value is an integer (with a scale of 0) in range.
+        bool ToBigInt(const SQL_NUMERIC_STRUCT& value, SQLBIGINT& result);
+
+        // Values of SQL_C_NUMERIC columns and parameters are only scaled correctly
+        // if the precision and scale are set in the application descriptor (the
+        // ones in SQL_NUMERIC_STRUCT are not used for input). descriptor is
+        // SQL_ATTR_APP_ROW_DESC or SQL_ATTR_APP_PARAM_DESC; data is the bound buffer,
+        // or null if values are to be read with SQLGetData(..., SQL_ARD_TYPE, ...).
+        SQLRETURN SetDescriptor(
+            SQLHSTMT hStmt,
+            SQLINTEGER descriptor,
+            SQLUSMALLINT recordNumber,
+            SQLSMALLINT precision,
+            SQLSMALLINT scale,
+            SQLPOINTER data);
+    }
+
+    Handle<Value> NumericToJS(const SQL_NUMERIC_STRUCT& value, NumericMode mode);
+    Handle<Value> BigIntToJS(SQLBIGINT value, NumericMode mode);
+}
@@ -1,8 +1,7 @@
 #pragma once 
 
 #include "eos.hpp"
-
-#include <uv.h>
+#include "workers.hpp"
 
 #if defined(DEBUG)
 #define DEBUG_ONLY(x) x
@@ -83,6 +82,13 @@ namespace Eos {
 
         virtual const char* GetName() const = 0;
 
+        // For operations waiting in their handle's queue (see EosHandle::Begin).
+        // StartQueued and CancelQueued are called on the main thread, and
+        // ChainedWork on the worker thread which ran the operation before.
+        virtual void StartQueued() = 0;
+        virtual void CancelQueued(Handle<Value> error) = 0;
+        virtual WorkItem* ChainedWork() = 0;
+
     protected:
 
         virtual SQLRETURN CallOverride() = 0;
@@ -179,6 +185,9 @@ namespace Eos {
             , begun_(false)
             , sync_(false)
             , result_(666)
+            , sequenced_(false)
+            , chains_(false)
+            , chained_(false)
             , ownerPtr_(nullptr) 
         { 
             EOS_DEBUG_METHOD();
@@ -319,19 +328,69 @@ namespace Eos {
         }
 #endif
 
-        void RunOnThreadPool() {
-            EOS_DEBUG_METHOD();
+        // Whether the next operation in the handle's queue can be started on
+        // the worker thread as soon as this one returns, before this one's
+        // callback. Operations whose callbacks use the handle, or buffers which
+        // the next operation could overwrite, hide this and return false.
+        bool ChainsOnWorker() { return true; }
+
+        // Called by EosHandle::Begin for operations which go through the
+        // handle's queue, before they are run or queued.
+        void Sequence() {
+            sequenced_ = true;
+            chains_ = static_cast<TOp*>(this)->ChainsOnWorker();
+        }
 
+        // Holds the references until the operation has run, or been
+        // cancelled while waiting in the queue.
+        void Enqueue() {
             Begin();
+        }
+
+        void StartQueued() {
+            QueueWork();
+        }
 
-            new(&req_) uv_work_t;
-            req_.data = this;
+        void CancelQueued(Handle<Value> error) {
+            EOS_DEBUG_METHOD();
+
+            MarkCompleted();
 
-            uv_queue_work(
-                uv_default_loop(),
-                &req_,
-                &UVWorkCallback,
-                &UVCompletedCallback);
+            TryCatch tc;
+            Handle<Value> argv[] = { error };
+            MakeCallback(argv);
+            if (tc.HasCaught())
+                FatalException(tc);
+        }
+
+        WorkItem* ChainedWork() {
+            PrepareWork();
+            return &work_;
+        }
+
+        // Runs an operation which has already completed on the thread pool again,
+        // through the handle's queue like a new one. This is for operations which
+        // keep working in the background between callbacks (e.g. reading ahead).
+        // Each run holds its own references, which are released by MakeCallback
+        // or CompleteWithoutCallback.
+        void RunOnThreadPoolAgain() {
+            EOS_DEBUG_METHOD();
+
+            assert(begun_ && completed_);
+            completed_ = false;
+
+            AddReferences();
+            Sequence();
+            if (Owner()->QueueOrRun(this))
+                QueueWork();
+        }
+
+        // For operations which their owner keeps between runs: stops the
+        // operation from keeping its owner alive too, so that neither keeps
+        // the other alive once JS has let go of the owner. The owner is still
+        // referenced while the operation is running (see AddReferences).
+        void ReleaseOwner() {
+            NanDisposePersistent(owner_);
         }
 
     protected:
@@ -345,6 +404,10 @@ namespace Eos {
 
             begun_ = true;
 
+            AddReferences();
+        }
+
+        void AddReferences() {
             DEBUG_ONLY(numberOfBegunOperations++);
             DEBUG_ONLY(activeOperations_.push_back(this));
 
@@ -352,6 +415,17 @@ namespace Eos {
             this->Ref();
         }
 
+        void PrepareWork() {
+            work_.Work = &WorkCallback;
+            work_.Done = &CompletedCallback;
+            work_.data = this;
+        }
+
+        void QueueWork() {
+            PrepareWork();
+            WorkerPool::Queue(&work_, Owner()->WorkerAffinity());
+        }
+
         // Default implementation.
         void CallbackOverride(SQLRETURN ret) {
             EOS_DEBUG_METHOD();
@@ -380,9 +454,27 @@ namespace Eos {
             MakeCallback(argc, argv);
         }
 
+        // Releases the references held while running, for a run which has
+        // nobody to call back yet.
+        void CompleteWithoutCallback() {
+            Owner()->Unref();
+            Unref();
+        }
+
+        bool IsCompleted() const { return completed_; }
+
         // Removes from the active operations list, and performs the callback, catching
         // any errors (and raising as fatal exceptions).
         void Complete() {
+            MarkCompleted();
+
+            TryCatch tc;
+            CallbackOverride(result_);
+            if (tc.HasCaught())
+                FatalException(tc);
+        }
+
+        void MarkCompleted() {
             assert(begun_ && !completed_);
             completed_ = true;
 
@@ -398,29 +490,47 @@ namespace Eos {
             assert(find(activeOperations_.cbegin(), activeOperations_.cend(), this) 
                 == activeOperations_.cend()); 
 #endif
-
-            TryCatch tc;
-            CallbackOverride(result_);
-            if (tc.HasCaught())
-                FatalException(tc);
         }
 
-#pragma region UV thread pool code
-        static void UVWorkCallback(uv_work_t* req) {
-            auto op = static_cast<Operation<TOwner, TOp>*>(req->data);
-            assert(op && &op->req_ == req);
+#pragma region Worker thread code
+        static void WorkCallback(WorkItem* item) {
+            auto op = static_cast<Operation<TOwner, TOp>*>(item->data);
+            assert(op && &op->work_ == item);
 
             op->result_ = op->CallOverride();
+
+            // Carry straight on with the next operation on the handle, unless
+            // this one's callback has to look at the handle first (e.g. for
+            // diagnostics)
+            if (op->sequenced_ && op->chains_ 
+                && (op->result_ == SQL_SUCCESS || op->result_ == SQL_NO_DATA)) 
+            {
+                if (auto next = op->Owner()->TakeQueuedOperation()) {
+                    op->chained_ = true;
+                    item->then = next->ChainedWork();
+                }
+            }
         }
 
-        static void UVCompletedCallback(uv_work_t* req, int status) {
-            auto op = static_cast<Operation<TOwner, TOp>*>(req->data);
-            assert(op && &op->req_ == req);
+        static void CompletedCallback(WorkItem* item) {
+            auto op = static_cast<Operation<TOwner, TOp>*>(item->data);
+            assert(op && &op->work_ == item);
             assert(op->begun_ && !op->completed_);
 
             NanScope();
 
+            // The next queued operation starts after the callback, unless it
+            // has already been started on the worker thread
+            IOperation* next = nullptr;
+            if (op->sequenced_)
+                next = op->Owner()->OperationCompleted(op->chained_);
+
             op->Complete();
+
+            if (next) {
+                next->StartQueued();
+                WorkerPool::Release();
+            }
         }
 #pragma endregion 
 
@@ -428,10 +538,14 @@ namespace Eos {
         Operation(const Operation<TOwner, TOp>& other); // = delete
 
         // For thread pool tasks
-        uv_work_t req_;
+        WorkItem work_;
         SQLRETURN result_;
 
         bool completed_, begun_, sync_;
+
+        // Whether the operation goes through its handle's queue, may start
+        // the next one on the worker thread, and did so
+        bool sequenced_, chains_, chained_;
         TOwner* ownerPtr_;
         Persistent<Object> owner_;
         static Persistent<FunctionTemplate> constructor_;
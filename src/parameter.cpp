@@ -1,5 +1,7 @@
 #include "parameter.hpp"
+#include "handle.hpp"
 #include "buffer.hpp"
+#include "numeric.hpp"
 
 using namespace Eos;
 using namespace Eos::Buffers;
@@ -22,26 +24,44 @@ void Parameter::Init(Handle<Object> exports) {
 }
 
 Parameter::Parameter
-    ( SQLUSMALLINT parameterNumber
+    ( BufferPool* pool
+    , SQLUSMALLINT parameterNumber
     , SQLSMALLINT inOutType
     , SQLSMALLINT sqlType
     , SQLSMALLINT cType
+    , SQLSMALLINT decimalDigits
     , void* buffer
     , SQLLEN length
     , Handle<Object> bufferObject
     , SQLLEN indicator
     ) 
-    : parameterNumber_(parameterNumber)
+    : pool_(pool)
+    , statement_(nullptr)
+    , parameterNumber_(parameterNumber)
     , inOutType_(inOutType)
     , sqlType_(sqlType)
     , cType_(cType)
+    , decimalDigits_(decimalDigits)
     , buffer_(buffer)
     , length_(length)
     , indicator_(indicator)
+    , columnSize_(0)
 {
     NanAssignPersistent(bufferObject_, bufferObject);
 
     EOS_DEBUG_METHOD_FMT(L"buffer = 0x%p, length = %i", buffer, length);
+
+    pool_->AddRef();
+}
+
+// Throws, and returns false, if the statement is running.
+bool Parameter::CheckNotRunning() const {
+    if (statement_ && statement_->IsRunning()) {
+        NanThrowError("Cannot change a bound parameter while an operation is in progress on its statement");
+        return false;
+    }
+
+    return true;
 }
 
 NAN_GETTER(Parameter::GetBuffer) const {
@@ -49,6 +69,9 @@ NAN_GETTER(Parameter::GetBuffer) const {
 }
 
 NAN_SETTER(Parameter::SetBuffer) {
+    if (!CheckNotRunning())
+        return;
+
     if (inOutType_ != SQL_PARAM_INPUT) {
         NanThrowError("Cannot set buffer for input/output or output parameters");
         return;
@@ -85,6 +108,9 @@ NAN_GETTER(Parameter::GetBytesInBuffer) const {
 }
 
 NAN_SETTER(Parameter::SetBytesInBuffer) {
+    if (!CheckNotRunning())
+        return;
+
     if (inOutType_ != SQL_PARAM_INPUT && inOutType_ != SQL_PARAM_INPUT_OUTPUT && inOutType_ != SQL_PARAM_INPUT_OUTPUT_STREAM) {
         NanThrowError("Cannot set bytesInBuffer for output parameters");
         return;
@@ -133,6 +159,7 @@ SQLLEN Parameter::BytesInBuffer() const {
 }
 
 const char* Parameter::Marshal(
+    BufferPool* pool,
     SQLUSMALLINT parameterNumber, 
     SQLSMALLINT inOutType, 
     SQLSMALLINT sqlType,
@@ -165,7 +192,7 @@ const char* Parameter::Marshal(
             indicator = SQL_NULL_DATA;
         } else if(handle.IsEmpty()) {
             // It's an input parameter, and we have a value.
-            if (!AllocateBoundInputParameter(cType, jsValue, buffer, length, handle))
+            if (!AllocateBoundInputParameter(pool, cType, jsValue, buffer, length, handle, decimalDigits))
                 return "Cannot allocate buffer for bound input or input/output parameter";
             indicator = length;
         } else {
@@ -175,7 +202,7 @@ const char* Parameter::Marshal(
                 return "The passed buffer is too small";
 
             // Now fill the buffer with the marhsalled value
-            indicator = FillInputBuffer(cType, jsValue, buffer, length);
+            indicator = FillInputBuffer(cType, jsValue, buffer, length, decimalDigits);
             if (!indicator)
                 return "Cannot place parameter value into buffer";
         }
@@ -186,7 +213,7 @@ const char* Parameter::Marshal(
         // It's an output parameter, in a bound buffer, or a DAE input parameter with a
         // bound output buffer.
         if (handle.IsEmpty()) {
-            if (!AllocateOutputBuffer(cType, buffer, length, handle))
+            if (!AllocateOutputBuffer(pool, cType, buffer, length, handle))
                 return "Cannot allocate buffer for output parameter";
         }
 
@@ -206,7 +233,7 @@ const char* Parameter::Marshal(
 
     assert(buffer == nullptr || !handle.IsEmpty());
 
-    auto param = new(nothrow) Parameter(parameterNumber, inOutType, sqlType, cType, buffer, length, handle, indicator);
+    auto param = new(nothrow) Parameter(pool, parameterNumber, inOutType, sqlType, cType, decimalDigits, buffer, length, handle, indicator);
     if (!param)
         return "Out of memory allocating parameter structure";
 
@@ -238,6 +265,9 @@ NAN_GETTER(Parameter::GetValue) const {
 }
 
 NAN_SETTER(Parameter::SetValue) {
+    if (!CheckNotRunning())
+        return;
+
     if (value->IsNull()) {
         indicator_ = SQL_NULL_DATA;
         return;
@@ -245,7 +275,7 @@ NAN_SETTER(Parameter::SetValue) {
 
     if (bufferObject_.IsEmpty()) {
 	Local<Object> buf = NanNew(bufferObject_);
-        if (AllocateBoundInputParameter(cType_, value, buffer_, length_, buf)) {
+        if (AllocateBoundInputParameter(pool_, cType_, value, buffer_, length_, buf, decimalDigits_)) {
 	    NanAssignPersistent(bufferObject_, buf);
 	} else {
             NanThrowError("Cannot allocate buffer for parameter data");
@@ -259,7 +289,7 @@ NAN_SETTER(Parameter::SetValue) {
             return;
         }
 
-        indicator_ = FillInputBuffer(cType_, value, buffer_, length_);
+        indicator_ = FillInputBuffer(cType_, value, buffer_, length_, decimalDigits_);
         if (!indicator_) {
             NanThrowError("Cannot place parameter value into buffer");
             return;
@@ -267,8 +297,103 @@ NAN_SETTER(Parameter::SetValue) {
     }
 }
 
+const char* Parameter::Assign(Handle<Value> value, bool& rebind) {
+    rebind = false;
+
+    if (inOutType_ != SQL_PARAM_INPUT && inOutType_ != SQL_PARAM_INPUT_OUTPUT)
+        return "Only input and input/output parameters can be given a value";
+
+    if (value->IsNull() || value->IsUndefined()) {
+        indicator_ = SQL_NULL_DATA;
+        return nullptr;
+    }
+
+    // Buffers are bound as they are, as bindParameter does
+    if (cType_ == SQL_C_BINARY) {
+        if (!JSBuffer::HasInstance(value) && !node::Buffer::HasInstance(value))
+            return "The value of a binary parameter should be a Buffer";
+
+        SQLPOINTER data;
+        SQLLEN dataLength;
+        if (auto msg = JSBuffer::Unwrap(value.As<Object>(), data, dataLength))
+            return msg;
+
+        rebind = data != buffer_ || dataLength != length_;
+        NanAssignPersistent(bufferObject_, value.As<Object>());
+        buffer_ = data;
+        length_ = indicator_ = dataLength;
+        return nullptr;
+    }
+
+    auto fixedLength = GetDesiredBufferLength(cType_);
+    auto required = fixedLength;
+    if (required == 0) {
+        auto str = value->ToString();
+        if (str.IsEmpty())
+            return "Cannot convert the parameter value to a string";
+
+        required = cType_ == SQL_C_CHAR ? str->Utf8Length() : str->Length() * sizeof(SQLWCHAR);
+    }
+
+    // A parameter without a buffer (bound as null or data-at-execution) gets
+    // one now. Buffers which are too small are replaced by one at least twice
+    // as big, so that ever longer values don't need a new buffer every time.
+    if (bufferObject_.IsEmpty() || length_ < required) {
+        auto length = bufferObject_.IsEmpty() ? required : max(required, length_ * 2);
+        if (length < 1)
+            length = 1;
+
+        SQLPOINTER buffer;
+        Handle<Object> handle;
+        if (!Allocate(pool_, length, buffer, handle))
+            return "Cannot allocate buffer for parameter data";
+
+        NanAssignPersistent(bufferObject_, handle);
+        buffer_ = buffer;
+        length_ = length;
+        rebind = true;
+    }
+
+    auto indicator = FillInputBuffer(cType_, value, buffer_, length_, decimalDigits_);
+    if (!indicator && fixedLength)
+        return "Cannot place parameter value into buffer";
+
+    indicator_ = indicator;
+    return nullptr;
+}
+
+SQLRETURN Parameter::Bind(SQLHSTMT hStmt, SQLULEN columnSize) {
+    columnSize_ = columnSize;
+
+    auto ret = SQLBindParameter(
+        hStmt,
+        parameterNumber_,
+        inOutType_,
+        cType_,
+        sqlType_,
+        columnSize,
+        decimalDigits_,
+        buffer_,
+        length_,
+        &indicator_);
+
+    if (!SQL_SUCCEEDED(ret) || cType_ != SQL_C_NUMERIC)
+        return ret;
+
+    // The precision and scale of SQL_C_NUMERIC values are taken from the APD
+    return Numerics::SetDescriptor(
+        hStmt,
+        SQL_ATTR_APP_PARAM_DESC,
+        parameterNumber_,
+        columnSize > 0 ? static_cast<SQLSMALLINT>(columnSize) : 38,
+        decimalDigits_,
+        buffer_);
+}
+
 Parameter::~Parameter() {
     EOS_DEBUG_METHOD();
+
+    pool_->Release();
 }
 
 namespace { ClassInitializer<Parameter> init; } 
@@ -1,10 +1,13 @@
 #pragma once 
 
 #include "eos.hpp"
+#include "pool.hpp"
 
 namespace Eos {
+    struct EosHandle;
+
     struct Parameter: ObjectWrap {
-        Parameter(SQLUSMALLINT parameterNumber, SQLSMALLINT inOutType, SQLSMALLINT sqlType, SQLSMALLINT cType, void* buffer, SQLLEN length, Handle<Object> bufferObject, SQLLEN indicator);
+        Parameter(BufferPool* pool, SQLUSMALLINT parameterNumber, SQLSMALLINT inOutType, SQLSMALLINT sqlType, SQLSMALLINT cType, SQLSMALLINT decimalDigits, void* buffer, SQLLEN length, Handle<Object> bufferObject, SQLLEN indicator);
         ~Parameter();
         
         static void Init(Handle<Object> exports);
@@ -27,6 +30,7 @@ namespace Eos {
     public:
 
         static const char* Marshal(
+            BufferPool* pool,
             SQLUSMALLINT parameterNumber, 
             SQLSMALLINT inOutType,
             SQLSMALLINT sqlType,
@@ -35,10 +39,26 @@ namespace Eos {
             Handle<Object> bufferObject,
             Handle<Object>& result);
 
+        // Writes a new input value into the parameter's buffer. If the buffer
+        // has to be replaced (by a bigger one from the pool, or by the value
+        // itself for binary data), rebind is set to true, and the parameter
+        // must be bound again. Returns an error message, or nullptr.
+        const char* Assign(Handle<Value> value, bool& rebind);
+
+        // Binds the parameter to the statement (again), including the
+        // precision and scale of numerics.
+        SQLRETURN Bind(SQLHSTMT hStmt, SQLULEN columnSize);
+        SQLRETURN Rebind(SQLHSTMT hStmt) { return Bind(hStmt, columnSize_); }
+
         static Parameter* Unwrap(Handle<Object> obj) { 
             return ObjectWrap::Unwrap<Parameter>(obj);
         }
 
+        // The statement the parameter is bound to with bindParameter, if any.
+        // Its buffer can't be changed while the statement is running (or has
+        // operations queued), since they may be reading it.
+        void SetStatement(const EosHandle* statement) { statement_ = statement; }
+
         void Ref() { EOS_DEBUG_METHOD(); ObjectWrap::Ref(); }
         void Unref() { EOS_DEBUG_METHOD(); ObjectWrap::Unref(); }
 
@@ -50,6 +70,7 @@ namespace Eos {
         SQLSMALLINT InOutType() const throw() { return inOutType_; }
         SQLSMALLINT SQLType() const throw() { return sqlType_; }
         SQLSMALLINT CType() const throw() { return cType_; }
+        SQLSMALLINT DecimalDigits() const throw() { return decimalDigits_; }
 
         const SQLLEN& Indicator() const throw() { return indicator_; }
         SQLLEN& Indicator() throw() { return indicator_; }
@@ -59,13 +80,19 @@ namespace Eos {
     private:
         static Persistent<FunctionTemplate> constructor_;
 
-        SQLSMALLINT sqlType_, cType_;
+        BufferPool* pool_;
+        const EosHandle* statement_;
+
+        SQLSMALLINT sqlType_, cType_, decimalDigits_;
         SQLSMALLINT inOutType_;
         SQLUSMALLINT parameterNumber_;
 
         void* buffer_;
         SQLLEN length_, indicator_;
+        SQLULEN columnSize_;
 
         Persistent<Object> bufferObject_;
+
+        bool CheckNotRunning() const;
     };
 }
@@ -0,0 +1,143 @@
+#include "pool.hpp"
+
+#include <cstdlib>
+
+using namespace Eos;
+
+BufferPool::BufferPool()
+    : refs_(1)
+    , hits_(0)
+    , misses_(0)
+    , bytesInUse_(0)
+    , bytesPooled_(0)
+{
+    EOS_DEBUG_METHOD();
+}
+
+BufferPool::~BufferPool() {
+    EOS_DEBUG_METHOD();
+
+    assert(bytesInUse_ == 0);
+
+    for (int i = 0; i < SizeClasses; i++) {
+        for (auto it = free_[i].begin(); it != free_[i].end(); ++it)
+            free(*it);
+    }
+}
+
+BufferPool::Header* BufferPool::GetHeader(const char* buffer) {
+    return reinterpret_cast<Header*>(const_cast<char*>(buffer)) - 1;
+}
+
+SQLLEN BufferPool::Capacity(const char* buffer) {
+    auto header = GetHeader(buffer);
+    return header->sizeClass >= 0 ? SizeOfClass(header->sizeClass) : -header->sizeClass - 1;
+}
+
+char* BufferPool::Borrow(SQLLEN length) {
+    EOS_DEBUG_METHOD_FMT(L"%li", static_cast<long>(length));
+
+    assert(length >= 0);
+
+    SQLLEN sizeClass = 0;
+    while (sizeClass < SizeClasses && SizeOfClass(sizeClass) < length)
+        sizeClass++;
+
+    Header* header;
+    SQLLEN capacity;
+
+    if (sizeClass == SizeClasses) {
+        // Too big to pool; remember the length in the size class instead
+        capacity = length;
+        header = static_cast<Header*>(malloc(sizeof(Header) + capacity));
+        if (!header)
+            return nullptr;
+
+        header->sizeClass = -capacity - 1;
+        misses_++;
+    } else if (!free_[sizeClass].empty()) {
+        capacity = SizeOfClass(sizeClass);
+        header = free_[sizeClass].back();
+        free_[sizeClass].pop_back();
+        bytesPooled_ -= capacity;
+        hits_++;
+    } else {
+        capacity = SizeOfClass(sizeClass);
+        header = static_cast<Header*>(malloc(sizeof(Header) + capacity));
+        if (!header)
+            return nullptr;
+
+        header->sizeClass = sizeClass;
+        misses_++;
+    }
+
+    header->pool = this;
+    bytesInUse_ += capacity;
+    AddRef();
+
+    return reinterpret_cast<char*>(header + 1);
+}
+
+void BufferPool::Return(char* buffer) {
+    EOS_DEBUG_METHOD();
+
+    if (!buffer)
+        return;
+
+    auto header = GetHeader(buffer);
+    auto pool = header->pool;
+    auto capacity = Capacity(buffer);
+
+    pool->bytesInUse_ -= capacity;
+
+    auto sizeClass = header->sizeClass;
+    if (sizeClass >= 0
+        && SQLLEN(pool->free_[sizeClass].size() + 1) * capacity <= max<SQLLEN>(MaxIdleBytes, 4 * capacity))
+    {
+        pool->free_[sizeClass].push_back(header);
+        pool->bytesPooled_ += capacity;
+    } else {
+        free(header);
+    }
+
+    pool->Release();
+}
+
+namespace {
+    void FreePooledBuffer(char* data, void*) {
+        BufferPool::Return(data);
+    }
+}
+
+Handle<Object> BufferPool::NewBuffer(SQLLEN length, SQLPOINTER& data) {
+    EOS_DEBUG_METHOD_FMT(L"%li", static_cast<long>(length));
+
+    auto buffer = Borrow(length);
+    if (!buffer)
+        return Handle<Object>();
+
+    auto handle = NanNewBufferHandle(buffer, static_cast<uint32_t>(length), FreePooledBuffer, nullptr);
+    if (handle.IsEmpty()) {
+        Return(buffer);
+        return handle;
+    }
+
+#if !defined(NODE_12)
+    // Node 0.10 gives us a SlowBuffer; wrap it in a Buffer like the ones
+    // which Buffer's own constructor makes (i.e. new Buffer(parent, length, offset)).
+    Handle<Value> argv[] = { handle, NanNew<Integer>(static_cast<int32_t>(length)), NanNew<Integer>(0) };
+    handle = JSBuffer::Constructor()->NewInstance(3, argv);
+#endif
+
+    data = buffer;
+    return handle;
+}
+
+Handle<Object> BufferPool::Stats() const {
+    auto stats = NanNew<Object>();
+    stats->Set(NanSymbol("hits"), NanNew<Number>(hits_));
+    stats->Set(NanSymbol("misses"), NanNew<Number>(misses_));
+    stats->Set(NanSymbol("bytesInUse"), NanNew<Number>(static_cast<double>(bytesInUse_)));
+    stats->Set(NanSymbol("bytesPooled"), NanNew<Number>(static_cast<double>(bytesPooled_)));
+    return stats;
+}
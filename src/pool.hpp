@@ -0,0 +1,70 @@
+#pragma once
+
+#include "eos.hpp"
+
+#include <vector>
+
+namespace Eos {
+    // A pool of native buffers in power-of-two size classes (64 bytes to 64KiB),
+    // so that getData and parameter/column bindings can reuse memory instead of
+    // allocating a new Buffer every time. Larger buffers are allocated and freed
+    // as usual, but are still counted in the statistics.
+    //
+    // Each environment has a pool, shared by its connections and statements.
+    // The pool is reference counted, and every borrowed buffer holds a
+    // reference, so buffers can safely be returned after the environment has
+    // been garbage collected.
+    //
+    // The pool is not thread safe: buffers must be borrowed and returned on
+    // the main thread, though they can be used on the thread pool in between.
+    struct BufferPool {
+        BufferPool();
+
+        void AddRef() { refs_++; }
+        void Release() { if (--refs_ == 0) delete this; }
+
+        // Returns a buffer with room for at least length bytes, or nullptr if
+        // out of memory.
+        char* Borrow(SQLLEN length);
+
+        // Gives a buffer returned by Borrow back to the pool it came from.
+        static void Return(char* buffer);
+
+        // The number of usable bytes in a buffer returned by Borrow.
+        static SQLLEN Capacity(const char* buffer);
+
+        // Creates a node Buffer of the given length which uses a borrowed
+        // buffer, which is returned when the Buffer is garbage collected.
+        Handle<Object> NewBuffer(SQLLEN length, SQLPOINTER& data);
+
+        // { hits, misses, bytesInUse, bytesPooled }
+        Handle<Object> Stats() const;
+
+    private:
+        ~BufferPool();
+        BufferPool(const BufferPool&); // = delete
+        void operator=(const BufferPool&); // = delete
+
+        // Precedes the data of every borrowed buffer. Two pointer-sized fields
+        // keep the data as aligned as malloc's.
+        struct Header {
+            BufferPool* pool;
+            SQLLEN sizeClass; // -1 if too big to pool
+        };
+
+        static const int MinSizeShift = 6, MaxSizeShift = 16;
+        static const int SizeClasses = MaxSizeShift - MinSizeShift + 1;
+
+        // Idle buffers kept per size class, in bytes (but at least 4 buffers).
+        static const SQLLEN MaxIdleBytes = 1024 * 1024;
+
+        static Header* GetHeader(const char* buffer);
+        static SQLLEN SizeOfClass(SQLLEN sizeClass) { return SQLLEN(1) << (sizeClass + MinSizeShift); }
+
+        int refs_;
+        std::vector<Header*> free_[SizeClasses];
+
+        double hits_, misses_;
+        SQLLEN bytesInUse_, bytesPooled_;
+    };
+}
@@ -0,0 +1,651 @@
+#include "result.hpp"
+#include "timestamp.hpp"
+#include "numeric.hpp"
+#include "buffer.hpp"
+
+using namespace Eos;
+
+ColumnDescription::ColumnDescription()
+    : dataType(SQL_UNKNOWN_TYPE)
+    , columnSize(0)
+    , decimalDigits(0)
+    , nullable(SQL_NULLABLE_UNKNOWN)
+{
+}
+
+SQLRETURN ColumnDescription::Describe(SQLHSTMT hStmt, SQLUSMALLINT columnNumber) {
+    EOS_DEBUG_METHOD_FMT(L"%hu", columnNumber);
+
+    // Most column names are short, so try with a small buffer first and only
+    // ask again if the name was truncated.
+    SQLSMALLINT nameLength = 0;
+    name.resize(64);
+
+    for (;;) {
+        auto ret = SQLDescribeColW(
+            hStmt,
+            columnNumber,
+            &name[0], static_cast<SQLSMALLINT>(name.size()), &nameLength,
+            &dataType,
+            &columnSize,
+            &decimalDigits,
+            &nullable);
+
+        if (!SQL_SUCCEEDED(ret))
+            return ret;
+
+        if (nameLength < static_cast<SQLSMALLINT>(name.size())) {
+            name.resize(nameLength);
+            return ret;
+        }
+
+        name.resize(nameLength + 1);
+    }
+}
+
+Local<String> ColumnDescription::Name() const {
+    if (name.empty())
+        return NanNew<String>("");
+
+    return StringFromTChar(&name[0], static_cast<int>(name.size()));
+}
+
+ColumnAttributes::ColumnAttributes()
+    : octetLength(0)
+    , isUnsigned(SQL_FALSE)
+{
+}
+
+namespace {
+    // Like ColumnDescription::Describe, tries a small buffer first and only
+    // asks again if the value was truncated.
+    SQLRETURN GetStringAttribute(SQLHSTMT hStmt, SQLUSMALLINT columnNumber, SQLUSMALLINT field, std::vector<SQLWCHAR>& value) {
+        value.resize(64);
+
+        for (;;) {
+            SQLSMALLINT bytes = 0;
+            auto ret = SQLColAttributeW(
+                hStmt,
+                columnNumber,
+                field,
+                &value[0], static_cast<SQLSMALLINT>(value.size() * sizeof(SQLWCHAR)), &bytes,
+                nullptr);
+
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+
+            auto length = bytes / static_cast<SQLSMALLINT>(sizeof(SQLWCHAR));
+            if (length < static_cast<SQLSMALLINT>(value.size())) {
+                value.resize(length);
+                return ret;
+            }
+
+            value.resize(length + 1);
+        }
+    }
+
+    Local<String> AttributeToJS(const std::vector<SQLWCHAR>& value) {
+        if (value.empty())
+            return NanNew<String>("");
+
+        return StringFromTChar(&value[0], static_cast<int>(value.size()));
+    }
+}
+
+SQLRETURN ColumnAttributes::Describe(SQLHSTMT hStmt, SQLUSMALLINT columnNumber) {
+    EOS_DEBUG_METHOD_FMT(L"%hu", columnNumber);
+
+    auto ret = desc.Describe(hStmt, columnNumber);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLColAttributeW(hStmt, columnNumber, SQL_DESC_OCTET_LENGTH, nullptr, 0, nullptr, &octetLength);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLColAttributeW(hStmt, columnNumber, SQL_DESC_UNSIGNED, nullptr, 0, nullptr, &isUnsigned);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = GetStringAttribute(hStmt, columnNumber, SQL_DESC_TABLE_NAME, tableName);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    return GetStringAttribute(hStmt, columnNumber, SQL_DESC_BASE_COLUMN_NAME, baseColumnName);
+}
+
+Handle<Array> Eos::ColumnAttributesToJS(const std::vector<ColumnAttributes>& columns) {
+    auto kName = NanSymbol("name");
+    auto kDataType = NanSymbol("dataType");
+    auto kColumnSize = NanSymbol("columnSize");
+    auto kDecimalDigits = NanSymbol("decimalDigits");
+    auto kNullable = NanSymbol("nullable");
+    auto kOctetLength = NanSymbol("octetLength");
+    auto kUnsigned = NanSymbol("unsigned");
+    auto kTableName = NanSymbol("tableName");
+    auto kBaseColumnName = NanSymbol("baseColumnName");
+
+    auto result = NanNew<Array>(static_cast<int>(columns.size()));
+    for (size_t i = 0; i < columns.size(); i++) {
+        auto& column = columns[i];
+        auto& desc = column.desc;
+
+        auto jsColumn = NanNew<Object>();
+        jsColumn->Set(kName, desc.Name());
+        jsColumn->Set(kDataType, NanNew<Integer>(desc.dataType));
+        jsColumn->Set(kColumnSize, NanNew<Number>(static_cast<double>(desc.columnSize)));
+        jsColumn->Set(kDecimalDigits, NanNew<Integer>(desc.decimalDigits));
+
+        if (desc.nullable == SQL_NULLABLE)
+            jsColumn->Set(kNullable, NanTrue());
+        else if (desc.nullable == SQL_NO_NULLS)
+            jsColumn->Set(kNullable, NanFalse());
+        else
+            jsColumn->Set(kNullable, NanUndefined());
+
+        jsColumn->Set(kOctetLength, NanNew<Number>(static_cast<double>(column.octetLength)));
+        jsColumn->Set(kUnsigned, column.isUnsigned == SQL_TRUE ? NanTrue() : NanFalse());
+        jsColumn->Set(kTableName, AttributeToJS(column.tableName));
+        jsColumn->Set(kBaseColumnName, AttributeToJS(column.baseColumnName));
+
+        result->Set(static_cast<uint32_t>(i), jsColumn);
+    }
+
+    return result;
+}
+
+RowShape::RowShape() {
+    EOS_DEBUG_METHOD();
+}
+
+RowShape::~RowShape() {
+    EOS_DEBUG_METHOD();
+
+    NanDisposePersistent(template_);
+    NanDisposePersistent(names_);
+}
+
+namespace {
+    // Property names are internalized anyway when they are used, so this
+    // saves looking the name up in the string table for every row.
+    Local<String> InternalizedName(const std::vector<SQLWCHAR>& name) {
+        if (name.empty())
+            return NanSymbol("");
+
+#if defined(NODE_12)
+        return String::NewFromTwoByte(
+            nan_isolate, 
+            reinterpret_cast<const uint16_t*>(&name[0]), 
+            String::kInternalizedString, 
+            static_cast<int>(name.size()));
+#else
+        String::Utf8Value utf8(StringFromTChar(&name[0], static_cast<int>(name.size())));
+        return String::NewSymbol(*utf8, utf8.length());
+#endif
+    }
+}
+
+void RowShape::Rebuild() {
+    EOS_DEBUG_METHOD_FMT(L"%lu columns", static_cast<unsigned long>(columnNames_.size()));
+
+    auto tmpl = NanNew<ObjectTemplate>();
+    auto names = NanNew<Array>(static_cast<int>(columnNames_.size()));
+
+    // Later columns with the same name replace earlier ones, as they would
+    // if the properties were simply assigned.
+    for (size_t i = 0; i < columnNames_.size(); i++) {
+        auto name = InternalizedName(columnNames_[i]);
+        names->Set(static_cast<uint32_t>(i), name);
+        tmpl->Set(name, NanNull());
+    }
+
+    NanDisposePersistent(template_);
+    NanDisposePersistent(names_);
+    NanAssignPersistent(template_, tmpl);
+    NanAssignPersistent(names_, names);
+}
+
+void RowShape::GetNames(std::vector<Local<String> >& names) const {
+    auto array = NanNew(names_);
+    names.resize(columnNames_.size());
+    for (size_t i = 0; i < names.size(); i++)
+        names[i] = array->Get(static_cast<uint32_t>(i)).As<String>();
+}
+
+Local<Object> RowShape::NewRow() const {
+    return NanNew(template_)->NewInstance();
+}
+
+SQLLEN Eos::GetColumnBufferLength(SQLSMALLINT cType, SQLULEN columnSize) {
+    auto length = Buffers::GetDesiredBufferLength(cType);
+    if (length > 0)
+        return length;
+
+    // This matches the buffer size getData allocates when none is given.
+    const SQLULEN maxLength = 65536;
+
+    // Variable-length data: columnSize is in characters (or bytes, for
+    // binary columns), and is 0 when the driver doesn't know the size.
+    switch (cType) {
+    case SQL_C_BINARY:
+        length = columnSize > 0 && columnSize < maxLength
+            ? columnSize
+            : maxLength;
+        break;
+
+    case SQL_C_CHAR:
+        // Allow for multi-byte UTF-8 sequences
+        length = columnSize > 0 && columnSize < maxLength / 4
+            ? columnSize * 4 + 1
+            : maxLength;
+        break;
+
+    case SQL_C_WCHAR:
+    default:
+        length = columnSize > 0 && columnSize < maxLength / sizeof(SQLWCHAR)
+            ? (columnSize + 1) * sizeof(SQLWCHAR)
+            : maxLength;
+        break;
+    }
+
+    // Keep the columns aligned
+    return (length + 7) & ~static_cast<SQLLEN>(7);
+}
+
+RowSet::RowSet()
+    : rowCount_(0)
+    , rowsFetched_(0)
+    , error_(nullptr)
+{
+    EOS_DEBUG_METHOD();
+}
+
+RowSet::~RowSet() {
+    EOS_DEBUG_METHOD();
+
+    Release();
+}
+
+void RowSet::Release() {
+    EOS_DEBUG_METHOD();
+
+    for (auto it = columns_.begin(); it != columns_.end(); ++it) {
+        delete[] it->data;
+        delete[] it->indicators;
+    }
+
+    columns_.clear();
+    rowStatus_.clear();
+    rowCount_ = rowsFetched_ = 0;
+}
+
+SQLRETURN RowSet::Describe(SQLHSTMT hStmt, std::vector<Column>& columns, const std::vector<ColumnAttributes>* described) {
+    EOS_DEBUG_METHOD();
+
+    SQLSMALLINT columnCount;
+    if (described) {
+        columnCount = static_cast<SQLSMALLINT>(described->size());
+    } else {
+        auto ret = SQLNumResultCols(hStmt, &columnCount);
+        if (!SQL_SUCCEEDED(ret))
+            return ret;
+    }
+
+    columns.resize(columnCount);
+    for (SQLSMALLINT i = 0; i < columnCount; i++) {
+        auto& column = columns[i];
+        column.data = nullptr;
+        column.indicators = nullptr;
+
+        if (described) {
+            column.desc = (*described)[i].desc;
+        } else {
+            auto ret = column.desc.Describe(hStmt, i + 1);
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+        }
+
+        column.cType = GetCTypeForSQLType(column.desc.dataType);
+        column.width = GetColumnBufferLength(column.cType, column.desc.columnSize);
+    }
+
+    return SQL_SUCCESS;
+}
+
+bool RowSet::Allocate(SQLULEN rowCount) {
+    EOS_DEBUG_METHOD_FMT(L"%lu", static_cast<unsigned long>(rowCount));
+
+    for (auto it = columns_.begin(); it != columns_.end(); ++it) {
+        it->data = new(nothrow) char[it->width * rowCount];
+        it->indicators = new(nothrow) SQLLEN[rowCount];
+
+        if (!it->data || !it->indicators)
+            return false;
+    }
+
+    rowStatus_.resize(rowCount);
+    rowCount_ = rowCount;
+    return true;
+}
+
+bool RowSet::CanReuse(const std::vector<Column>& columns, SQLULEN rowCount) const {
+    if (rowCount != rowCount_ || columns.size() != columns_.size())
+        return false;
+
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (columns[i].cType != columns_[i].cType || columns[i].width != columns_[i].width)
+            return false;
+
+        // fetchColumns takes ownership of some of the arrays
+        if (!columns_[i].data || !columns_[i].indicators)
+            return false;
+    }
+
+    return true;
+}
+
+SQLRETURN RowSet::Fetch(SQLHSTMT hStmt, SQLULEN rowCount, const std::vector<ColumnAttributes>* described) {
+    EOS_DEBUG_METHOD_FMT(L"%lu", static_cast<unsigned long>(rowCount));
+
+    assert(rowCount > 0);
+    error_ = nullptr;
+    rowsFetched_ = 0;
+
+    std::vector<Column> columns;
+    auto ret = Describe(hStmt, columns, described);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    SQLULEN rowBytes = sizeof(SQLUSMALLINT); // The row status
+    for (size_t i = 0; i < columns.size(); i++)
+        rowBytes += columns[i].width + sizeof(SQLLEN);
+
+    auto maxRows = max<SQLULEN>(1, MaxBlockBytes / rowBytes);
+    if (rowCount > maxRows)
+        rowCount = maxRows;
+
+    // Keep the arrays from the previous fetch if the result set has the same
+    // shape, which it will unless a new result set has been opened.
+    if (CanReuse(columns, rowCount)) {
+        for (size_t i = 0; i < columns.size(); i++)
+            columns_[i].desc = columns[i].desc;
+    } else {
+        Release();
+        columns_.swap(columns);
+
+        if (!Allocate(rowCount)) {
+            error_ = "Out of memory allocating column arrays";
+            Release();
+            return SQL_ERROR;
+        }
+    }
+
+    ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER)SQL_BIND_BY_COLUMN, SQL_IS_UINTEGER);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)rowCount, SQL_IS_UINTEGER);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_ROWS_FETCHED_PTR, &rowsFetched_, SQL_IS_POINTER);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_ROW_STATUS_PTR, &rowStatus_[0], SQL_IS_POINTER);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    for (SQLUSMALLINT i = 0; i < columns_.size(); i++) {
+        auto& column = columns_[i];
+        ret = SQLBindCol(
+            hStmt,
+            i + 1,
+            column.cType,
+            column.data, column.width,
+            column.indicators);
+
+        if (!SQL_SUCCEEDED(ret))
+            return ret;
+
+        // The driver only scales SQL_C_NUMERIC values as described in the ARD
+        if (column.cType == SQL_C_NUMERIC) {
+            ret = Numerics::SetDescriptor(
+                hStmt, SQL_ATTR_APP_ROW_DESC, i + 1,
+                static_cast<SQLSMALLINT>(column.desc.columnSize), column.desc.decimalDigits,
+                column.data);
+
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+        }
+    }
+
+    ret = SQLFetch(hStmt);
+    if (SQL_SUCCEEDED(ret) && IsTruncated()) {
+        error_ = "A value is too long to be fetched in a block of rows (the limit is 64KiB); use fetchRow to read it";
+        return SQL_ERROR;
+    }
+
+    return ret;
+}
+
+bool RowSet::IsTruncated() const {
+    for (auto it = columns_.begin(); it != columns_.end(); ++it) {
+        // The space left for the value once the null terminator is allowed for
+        SQLLEN capacity;
+        switch (it->cType) {
+        case SQL_C_BINARY: capacity = it->width; break;
+        case SQL_C_CHAR: capacity = it->width - 1; break;
+        case SQL_C_WCHAR: capacity = it->width - static_cast<SQLLEN>(sizeof(SQLWCHAR)); break;
+        default: continue;
+        }
+
+        for (SQLULEN row = 0; row < rowsFetched_; row++) {
+            if (rowStatus_[row] == SQL_ROW_ERROR || rowStatus_[row] == SQL_ROW_NOROW)
+                continue;
+
+            auto indicator = it->indicators[row];
+            if (indicator == SQL_NO_TOTAL || indicator > capacity)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+SQLRETURN RowSet::Unbind(SQLHSTMT hStmt) {
+    EOS_DEBUG_METHOD();
+
+    auto ret = SQLFreeStmt(hStmt, SQL_UNBIND);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_ROW_STATUS_PTR, nullptr, SQL_IS_POINTER);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_ROWS_FETCHED_PTR, nullptr, SQL_IS_POINTER);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    return SQLSetStmtAttrW(hStmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, SQL_IS_UINTEGER);
+}
+
+Handle<Value> RowSet::GetValue(SQLULEN row, SQLUSMALLINT columnIndex) const {
+    assert(row < rowsFetched_ && columnIndex < columns_.size());
+
+    auto& column = columns_[columnIndex];
+    auto indicator = column.indicators[row];
+    auto data = column.data + row * column.width;
+
+    if (indicator == SQL_NULL_DATA)
+        return NanNull();
+
+    switch (column.cType) {
+    case SQL_C_BINARY:
+        // Fetch() fails rather than returning a truncated value
+        assert(indicator >= 0 && indicator <= column.width);
+        return NanNewBufferHandle(data, static_cast<uint32_t>(indicator));
+
+    case SQL_C_CHAR: case SQL_C_WCHAR:
+        // ConvertToJS expects at least one character
+        if (indicator == 0)
+            return NanNew<String>("");
+
+    default:
+        return ConvertToJS(data, indicator, column.width, column.cType, nullptr, options_);
+    }
+}
+
+Handle<Array> RowSet::GetRow(SQLULEN row) const {
+    auto result = NanNew<Array>(ColumnCount());
+
+    for (SQLUSMALLINT i = 0; i < columns_.size(); i++)
+        result->Set(i, GetValue(row, i));
+
+    return result;
+}
+
+Handle<Array> RowSet::GetRows(RowShape& shape) const {
+    auto rows = NanNew<Array>();
+
+    std::vector<Local<String> > names;
+    if (options_.rows == RowObject) {
+        DescribeColumn describe = { columns_ };
+        shape.Update(columns_.size(), describe);
+        shape.GetNames(names);
+    }
+
+    uint32_t j = 0;
+    for (SQLULEN i = 0; i < rowsFetched_; i++) {
+        // Rows which could not be fetched are reported by the driver as diagnostic
+        // records on the statement; there is nothing in the arrays to convert.
+        if (rowStatus_[i] == SQL_ROW_ERROR || rowStatus_[i] == SQL_ROW_NOROW)
+            continue;
+
+        if (options_.rows == RowObject) {
+            auto row = shape.NewRow();
+            for (SQLUSMALLINT k = 0; k < columns_.size(); k++)
+                row->Set(names[k], GetValue(i, k));
+            rows->Set(j++, row);
+        } else {
+            rows->Set(j++, GetRow(i));
+        }
+    }
+
+    return rows;
+}
+
+#if defined(NODE_12)
+namespace {
+    NAN_WEAK_CALLBACK(FreeExternalArrayData) {
+        delete[] data.GetParameter();
+    }
+
+    // Creates an ArrayBuffer over memory allocated with new char[], which is
+    // freed when the ArrayBuffer is garbage collected.
+    Local<ArrayBuffer> NewExternalArrayBuffer(char* data, size_t length) {
+        auto buffer = ArrayBuffer::New(nan_isolate, data, length);
+        NanMakeWeakPersistent(buffer, data, &FreeExternalArrayData);
+        return buffer;
+    }
+
+    bool IsRowNull(SQLUSMALLINT status, SQLLEN indicator) {
+        return indicator == SQL_NULL_DATA 
+            || status == SQL_ROW_ERROR 
+            || status == SQL_ROW_NOROW;
+    }
+}
+
+Handle<Array> RowSet::GetColumns() {
+    auto result = NanNew<Array>(ColumnCount());
+
+    auto kName = NanSymbol("name");
+    auto kValues = NanSymbol("values");
+    auto kNulls = NanSymbol("nulls");
+
+    auto rows = rowsFetched_;
+    auto bitmapLength = (rows + 7) / 8;
+
+    for (SQLUSMALLINT i = 0; i < columns_.size(); i++) {
+        auto& column = columns_[i];
+
+        // One bit per row, set if the value in that row is null
+        auto bitmap = new char[bitmapLength]();
+        for (SQLULEN j = 0; j < rows; j++)
+            if (IsRowNull(rowStatus_[j], column.indicators[j]))
+                bitmap[j >> 3] |= 1 << (j & 7);
+
+        Local<Value> values;
+        switch (column.cType) {
+        case SQL_C_SLONG:
+            values = Int32Array::New(NewExternalArrayBuffer(column.data, rows * column.width), 0, rows);
+            column.data = nullptr;
+            break;
+
+        case SQL_C_DOUBLE:
+            values = Float64Array::New(NewExternalArrayBuffer(column.data, rows * column.width), 0, rows);
+            column.data = nullptr;
+            break;
+
+        case SQL_C_BIT:
+            values = Uint8Array::New(NewExternalArrayBuffer(column.data, rows * column.width), 0, rows);
+            column.data = nullptr;
+            break;
+
+        case SQL_C_TYPE_TIMESTAMP:
+            if (options_.timestamps == TimestampNumber) {
+                // Null elements are NaN. (The memory is freed as char[].)
+                auto times = reinterpret_cast<double*>(new char[rows * sizeof(double)]);
+                for (SQLULEN j = 0; j < rows; j++) {
+                    times[j] = IsRowNull(rowStatus_[j], column.indicators[j])
+                        ? NAN
+                        : Timestamps::ToEpochMilliseconds(reinterpret_cast<SQL_TIMESTAMP_STRUCT*>(column.data)[j]);
+                }
+
+                values = Float64Array::New(NewExternalArrayBuffer(reinterpret_cast<char*>(times), rows * sizeof(double)), 0, rows);
+                break;
+            }
+            // Fall through
+
+        case SQL_C_SBIGINT: case SQL_C_NUMERIC:
+            if (column.cType != SQL_C_TYPE_TIMESTAMP && options_.numerics == NumericNumber) {
+                // Null elements are NaN, as for timestamps
+                auto numbers = reinterpret_cast<double*>(new char[rows * sizeof(double)]);
+                for (SQLULEN j = 0; j < rows; j++) {
+                    if (IsRowNull(rowStatus_[j], column.indicators[j]))
+                        numbers[j] = NAN;
+                    else if (column.cType == SQL_C_SBIGINT)
+                        numbers[j] = static_cast<double>(reinterpret_cast<SQLBIGINT*>(column.data)[j]);
+                    else
+                        numbers[j] = Numerics::ToDouble(reinterpret_cast<SQL_NUMERIC_STRUCT*>(column.data)[j]);
+                }
+
+                values = Float64Array::New(NewExternalArrayBuffer(reinterpret_cast<char*>(numbers), rows * sizeof(double)), 0, rows);
+                break;
+            }
+            // Fall through
+
+        default: {
+            auto array = NanNew<Array>(static_cast<int>(rows));
+            for (SQLULEN j = 0; j < rows; j++) {
+                if (IsRowNull(rowStatus_[j], column.indicators[j]))
+                    array->Set(j, NanNull());
+                else
+                    array->Set(j, GetValue(j, i));
+            }
+            values = array;
+            break;
+        }
+        }
+
+        auto jsColumn = NanNew<Object>();
+        jsColumn->Set(kName, column.desc.Name());
+        jsColumn->Set(kValues, values);
+        jsColumn->Set(kNulls, Uint8Array::New(NewExternalArrayBuffer(bitmap, bitmapLength), 0, bitmapLength));
+        result->Set(i, jsColumn);
+    }
+
+    return result;
+}
+#endif
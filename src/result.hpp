@@ -0,0 +1,186 @@
+#pragma once
+
+#include "eos.hpp"
+
+#include <vector>
+
+namespace Eos {
+    // The information returned by SQLDescribeColW for a single result column.
+    struct ColumnDescription {
+        ColumnDescription();
+
+        // Safe to call from the thread pool.
+        SQLRETURN Describe(SQLHSTMT hStmt, SQLUSMALLINT columnNumber);
+
+        Local<String> Name() const;
+
+        std::vector<SQLWCHAR> name;
+        SQLSMALLINT dataType;
+        SQLULEN columnSize;
+        SQLSMALLINT decimalDigits;
+        SQLSMALLINT nullable;
+    };
+
+    // A column's description plus the column attributes which describeResultSet
+    // returns.
+    struct ColumnAttributes {
+        ColumnAttributes();
+
+        // Safe to call from the thread pool.
+        SQLRETURN Describe(SQLHSTMT hStmt, SQLUSMALLINT columnNumber);
+
+        ColumnDescription desc;
+        SQLLEN octetLength;
+        SQLLEN isUnsigned;
+        std::vector<SQLWCHAR> tableName, baseColumnName;
+    };
+
+    // The array of column objects which describeResultSet returns.
+    Handle<Array> ColumnAttributesToJS(const std::vector<ColumnAttributes>& columns);
+
+    // Creates the objects for rows of a result set when the row mode is
+    // RowObject. The column names are converted (and internalized) once per
+    // result set, and every row is created from the same ObjectTemplate, with
+    // its properties already in place, so that all of the rows share a hidden
+    // class instead of each one being built up property by property.
+    //
+    // Each statement keeps one, which is rebuilt when the column names change
+    // (i.e. for a new result set). Main thread only.
+    struct RowShape {
+        RowShape();
+        ~RowShape();
+
+        // Rebuilds the template unless the columns have the same names as
+        // last time. describe(i) returns the ColumnDescription of column i.
+        template<class Describe>
+        void Update(size_t columnCount, Describe describe) {
+            if (!Matches(columnCount, describe))
+                Rebuild(columnCount, describe);
+        }
+
+        // The name of each column, to set the row's properties with.
+        void GetNames(std::vector<Local<String> >& names) const;
+
+        Local<Object> NewRow() const;
+
+    private:
+        RowShape(const RowShape&); // = delete
+        void operator=(const RowShape&); // = delete
+
+        template<class Describe>
+        bool Matches(size_t columnCount, Describe describe) const {
+            if (template_.IsEmpty() || columnCount != columnNames_.size())
+                return false;
+
+            for (size_t i = 0; i < columnCount; i++)
+                if (describe(i).name != columnNames_[i])
+                    return false;
+
+            return true;
+        }
+
+        template<class Describe>
+        void Rebuild(size_t columnCount, Describe describe) {
+            columnNames_.resize(columnCount);
+            for (size_t i = 0; i < columnCount; i++)
+                columnNames_[i] = describe(i).name;
+            Rebuild();
+        }
+
+        void Rebuild();
+
+        std::vector<std::vector<SQLWCHAR> > columnNames_;
+        Persistent<ObjectTemplate> template_;
+        Persistent<Array> names_;
+    };
+
+    // The number of bytes needed to hold one value of a column described as
+    // columnSize, when converted to cType, including the null terminator for
+    // character data. Unknown or very long columns are limited to 64KiB, and
+    // RowSet::Fetch fails if a value turns out not to fit.
+    SQLLEN GetColumnBufferLength(SQLSMALLINT cType, SQLULEN columnSize);
+
+    // The most memory a block of rows can bind. Unknown or (max) columns take
+    // 64KiB per row, so a block of those has fewer rows than were asked for.
+    const SQLULEN MaxBlockBytes = 64 * 1024 * 1024;
+
+    // A set of column-wise bound arrays, used to fetch a block of rows with a
+    // single call to SQLFetch (i.e. a block cursor).
+    //
+    // Fetch() may be called on the thread pool; everything which creates JS
+    // values must be called on the main thread once the fetch has completed.
+    struct RowSet {
+        RowSet();
+        ~RowSet();
+
+        // Describes the current result set, binds arrays for up to rowCount
+        // rows (fewer if they would take more than MaxBlockBytes), and
+        // fetches the next block of rows. The arrays are kept for
+        // the next call if the shape of the result set does not change.
+        // If described is given (from the statement's cached metadata), the
+        // columns are not described again. Fails, with Error() set, if any
+        // value in the block was too long for its column's array.
+        SQLRETURN Fetch(SQLHSTMT hStmt, SQLULEN rowCount, const std::vector<ColumnAttributes>* described = nullptr);
+
+        // Restores the statement to single-row fetching, so that fetch and
+        // getData behave as normal afterwards.
+        SQLRETURN Unbind(SQLHSTMT hStmt);
+
+        // Frees the column arrays.
+        void Release();
+
+        // Set if Fetch() failed for a reason other than an ODBC error.
+        const char* Error() const { return error_; }
+
+        // How timestamps and numerics are converted by the functions below.
+        void SetConversionOptions(const ConversionOptions& options) { options_ = options; }
+
+        SQLULEN RowsFetched() const { return rowsFetched_; }
+        SQLUSMALLINT ColumnCount() const { return static_cast<SQLUSMALLINT>(columns_.size()); }
+
+        Handle<Value> GetValue(SQLULEN row, SQLUSMALLINT column) const;
+        Handle<Array> GetRow(SQLULEN row) const;
+
+        // Returns an array of rows, which are arrays or (if the row mode is
+        // RowObject) objects created by shape.
+        Handle<Array> GetRows(RowShape& shape) const;
+
+#if defined(NODE_12)
+        // Returns the fetched block column by column. Numeric and bit columns
+        // are returned as typed arrays which take ownership of the bound column
+        // arrays, so this can only be called once per fetch. Timestamps are
+        // returned in a Float64Array if the timestamp mode is TimestampNumber,
+        // and so are BIGINT and DECIMAL columns if the numeric mode is NumericNumber.
+        Handle<Array> GetColumns();
+#endif
+
+    private:
+        RowSet(const RowSet&); // = delete
+        void operator=(const RowSet&); // = delete
+
+        struct Column {
+            ColumnDescription desc;
+            SQLSMALLINT cType;
+            SQLLEN width;
+            char* data;
+            SQLLEN* indicators;
+        };
+
+        // For RowShape::Update
+        struct DescribeColumn {
+            const std::vector<Column>& columns;
+            const ColumnDescription& operator()(size_t i) const { return columns[i].desc; }
+        };
+
+        static SQLRETURN Describe(SQLHSTMT hStmt, std::vector<Column>& columns, const std::vector<ColumnAttributes>* described);
+        bool CanReuse(const std::vector<Column>& columns, SQLULEN rowCount) const;
+        bool Allocate(SQLULEN rowCount);
+        bool IsTruncated() const;
+
+        std::vector<Column> columns_;
+        std::vector<SQLUSMALLINT> rowStatus_;
+        SQLULEN rowCount_, rowsFetched_;
+        const char* error_;
+        ConversionOptions options_;
+    };
+}
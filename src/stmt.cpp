@@ -1,5 +1,7 @@
 #include "stmt.hpp"
 #include "parameter.hpp"
+#include "column.hpp"
+#include "numeric.hpp"
 
 using namespace Eos;
 
@@ -14,18 +16,32 @@ void Statement::Init(Handle<Object> exports) {
     EOS_SET_METHOD(Constructor(), "prepare", Statement, Prepare, sig0);
     EOS_SET_METHOD(Constructor(), "execDirect", Statement, ExecDirect, sig0);
     EOS_SET_METHOD(Constructor(), "execute", Statement, Execute, sig0);
+    EOS_SET_METHOD(Constructor(), "executeBatch", Statement, ExecuteBatch, sig0);
+    EOS_SET_METHOD(Constructor(), "executeWith", Statement, ExecuteWith, sig0);
     EOS_SET_METHOD(Constructor(), "fetch", Statement, Fetch, sig0);
+    EOS_SET_METHOD(Constructor(), "fetchRow", Statement, FetchRow, sig0);
+    EOS_SET_METHOD(Constructor(), "fetchRows", Statement, FetchRows, sig0);
+    EOS_SET_METHOD(Constructor(), "fetchColumns", Statement, FetchColumns, sig0);
+    EOS_SET_METHOD(Constructor(), "fetchRowsAhead", Statement, FetchRowsAhead, sig0);
     EOS_SET_METHOD(Constructor(), "getData", Statement, GetData, sig0);
     EOS_SET_METHOD(Constructor(), "cancel", Statement, Cancel, sig0);
     EOS_SET_METHOD(Constructor(), "numResultCols", Statement, NumResultCols, sig0);
     EOS_SET_METHOD(Constructor(), "describeCol", Statement, DescribeCol, sig0);
+    EOS_SET_METHOD(Constructor(), "describeResultSet", Statement, DescribeResultSet, sig0);
     EOS_SET_METHOD(Constructor(), "paramData", Statement, ParamData, sig0);
     EOS_SET_METHOD(Constructor(), "putData", Statement, PutData, sig0);
     EOS_SET_METHOD(Constructor(), "moreResults", Statement, MoreResults, sig0);
+    EOS_SET_METHOD(Constructor(), "pipeline", Statement, Pipeline, sig0);
     EOS_SET_METHOD(Constructor(), "bindParameter", Statement, BindParameter, sig0);
+    EOS_SET_METHOD(Constructor(), "bindParameters", Statement, BindParameters, sig0);
     EOS_SET_METHOD(Constructor(), "setParameterName", Statement, SetParameterName, sig0);
     EOS_SET_METHOD(Constructor(), "unbindParameters", Statement, UnbindParameters, sig0);
+    EOS_SET_METHOD(Constructor(), "bindColumn", Statement, BindColumn, sig0);
+    EOS_SET_METHOD(Constructor(), "unbindColumns", Statement, UnbindColumns, sig0);
     EOS_SET_METHOD(Constructor(), "closeCursor", Statement, CloseCursor, sig0);
+    EOS_SET_METHOD(Constructor(), "setTimestampMode", Statement, SetTimestampMode, sig0);
+    EOS_SET_METHOD(Constructor(), "setNumericMode", Statement, SetNumericMode, sig0);
+    EOS_SET_METHOD(Constructor(), "setRowMode", Statement, SetRowMode, sig0);
 }
 
 NAN_METHOD(Statement::New) {
@@ -46,16 +62,32 @@ NAN_METHOD(Statement::New) {
         return NanThrowTypeError("The first argument to Statement::New() must be a Connection");
 
     auto conn = ObjectWrap::Unwrap<Connection>(args[0]->ToObject());
+
+    // The idle handles may be being freed by SQLDisconnect
+    if (conn->IsDisconnecting())
+        return NanThrowError("Cannot create a statement while the connection is being disconnected");
     
     SQLHSTMT hStmt;
 
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    HANDLE hEvent = nullptr;
+
+    if (conn->TakeStatementHandle(hStmt, hEvent)) {
+        (new Statement(hStmt, conn, hEvent))->Wrap(args.Holder());
+        NanReturnValue(args.Holder());
+    }
+#else
+    if (conn->TakeStatementHandle(hStmt)) {
+        (new Statement(hStmt, conn))->Wrap(args.Holder());
+        NanReturnValue(args.Holder());
+    }
+#endif
+
     auto ret = SQLAllocHandle(SQL_HANDLE_STMT, conn->GetHandle(), &hStmt);
     if (!SQL_SUCCEEDED(ret))
         return NanThrowError(conn->GetLastError());
 
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
-    HANDLE hEvent = nullptr;
-
     ret = SQLSetStmtAttrW(
         hStmt,
         SQL_ATTR_ASYNC_ENABLE,
@@ -92,8 +124,17 @@ NAN_METHOD(Statement::New) {
 Statement::Statement(SQLHSTMT hStmt, Connection* conn EOS_ASYNC_ONLY_ARG(HANDLE hEvent)) 
     : EosHandle(SQL_HANDLE_STMT, hStmt EOS_ASYNC_ONLY_ARG(hEvent))
     , connection_(conn)
+    , pool_(conn->Pool())
+    , firstResultSet_(false)
+    , prepared_(false)
+    , generation_(conn->Generation())
 {
     EOS_DEBUG_METHOD();
+
+    pool_->AddRef();
+
+    // The connection (and its metadata cache) must outlive the statement
+    NanAssignPersistent(connectionObject_, NanObjectWrapHandle(conn));
 }
 
 NAN_METHOD(Statement::Cancel) {
@@ -110,15 +151,34 @@ NAN_METHOD(Statement::BindParameter) {
     
     if (args.Length() < 5)
         return NanThrowError("BindParameter expects 5, 6, or 7 arguments");
-    
-    if (!args[0]->IsInt32())
-        return NanThrowTypeError("The 1st argument should be an integer");
 
-    if (!args[1]->IsInt32())
-        return NanThrowTypeError("The 2nd argument should be an integer");
+    // Operations which are running or queued may be using the bindings
+    if (IsRunning())
+        return NanThrowError("Cannot bind parameters while an operation is in progress");
 
-    if (!args[2]->IsInt32())
-        return NanThrowTypeError("The 3rd argument should be an integer");
+    Handle<Value> argv[7];
+    for (int i = 0; i < 7; i++)
+        argv[i] = i < args.Length() ? args[i] : NanUndefined();
+
+    Local<Object> jsParam;
+    auto error = BindOneParameter(min(args.Length(), 7), argv, jsParam);
+    if (!error.IsEmpty())
+        return NanThrowError(error);
+
+    EosMethodReturnValue(jsParam);
+}
+
+// Binds a parameter (the arguments are those of bindParameter), returning the
+// exception to throw, or an empty handle.
+Handle<Value> Statement::BindOneParameter(int argc, Handle<Value> argv[], Local<Object>& jsParam) {
+    if (!argv[0]->IsInt32())
+        return NanTypeError("The 1st argument should be an integer");
+
+    if (!argv[1]->IsInt32())
+        return NanTypeError("The 2nd argument should be an integer");
+
+    if (!argv[2]->IsInt32())
+        return NanTypeError("The 3rd argument should be an integer");
 
     // 0. parameter number (e.g. 2)
     // 1. parameter kind (e.g. SQL_PARAM_INPUT)
@@ -128,75 +188,134 @@ NAN_METHOD(Statement::BindParameter) {
     // 5. value (e.g. 27)
     // 6. buffer to use (e.g. new Buffer(4))
 
-    auto parameterNumber = args[0]->Int32Value();
+    auto parameterNumber = argv[0]->Int32Value();
     if (parameterNumber < 1 || parameterNumber > USHRT_MAX)
-        return NanThrowError("The parameter number is incorrect (valid values: 1 - 65535)");
+        return NanError("The parameter number is incorrect (valid values: 1 - 65535)");
 
-    SQLSMALLINT inOutType = args[1]->Int32Value();
-    SQLSMALLINT sqlType = args[2]->Int32Value();
+    SQLSMALLINT inOutType = argv[1]->Int32Value();
+    SQLSMALLINT sqlType = argv[2]->Int32Value();
 
     // max digits for SQL_DECIMAL, SQL_NUMERIC, SQL_FLOAT, SQL_REAL, or SQL_DOUBLE
     // max length for SQL_*CHAR, SQL_*BINARY
-    SQLSMALLINT columnSize = args[3]->Int32Value();
-    if (args[3]->Int32Value() > SHRT_MAX)
-        return NanThrowRangeError("Column size is too high");
+    SQLSMALLINT columnSize = argv[3]->Int32Value();
+    if (argv[3]->Int32Value() > SHRT_MAX)
+        return NanRangeError("Column size is too high");
 
     // max digits after decimal point for SQL_NUMERIC/SQL_DECIMAL
-    SQLSMALLINT decimalDigits = args[4]->Int32Value();
-    if (auto j = args[4]->Int32Value() > SHRT_MAX)
-        return NanThrowRangeError("Decimal digits is too high");
+    SQLSMALLINT decimalDigits = argv[4]->Int32Value();
+    if (auto j = argv[4]->Int32Value() > SHRT_MAX)
+        return NanRangeError("Decimal digits is too high");
+
+    // Sizes which weren't given come from the prepared statement's
+    // parameter descriptions, if its metadata was cached
+    auto metadata = PreparedMetadata();
+    if (metadata && metadata->parametersDescribed && parameterNumber <= static_cast<int>(metadata->parameters.size())) {
+        auto& described = metadata->parameters[parameterNumber - 1];
+        if (!argv[3]->IsInt32() && described.parameterSize <= SHRT_MAX)
+            columnSize = static_cast<SQLSMALLINT>(described.parameterSize);
+        if (!argv[4]->IsInt32())
+            decimalDigits = described.decimalDigits;
+    }
 
     Handle<Value> jsValue = NanUndefined();
     Handle<Object> bufferObject;
 
-    if (args.Length() >= 6) 
-        jsValue = args[5];
+    if (argc >= 6) 
+        jsValue = argv[5];
 
-    if (args.Length() >= 7 && !args[6]->IsUndefined()) {
-        if (!JSBuffer::HasInstance(args[6]) && !Buffer::HasInstance(args[6]))
-            return NanThrowTypeError("The 7th argument should be a Buffer or SlowBuffer");
+    if (argc >= 7 && !argv[6]->IsUndefined()) {
+        if (!JSBuffer::HasInstance(argv[6]) && !Buffer::HasInstance(argv[6]))
+            return NanTypeError("The 7th argument should be a Buffer or SlowBuffer");
 
-        bufferObject = args[6].As<Object>();
+        bufferObject = argv[6].As<Object>();
     }
 
     bool dae = jsValue->IsUndefined();
 
-    Local<Object> jsParam;
-    auto msg = Parameter::Marshal(parameterNumber, inOutType, sqlType, decimalDigits, jsValue, bufferObject, jsParam);
+    auto msg = Parameter::Marshal(Pool(), parameterNumber, inOutType, sqlType, decimalDigits, jsValue, bufferObject, jsParam);
     if (msg) // Exception
-        return NanThrowError(msg);
+        return NanError(msg);
 
     auto param = Parameter::Unwrap(jsParam.As<Object>());
 
     // Setting the column length is only necessary for these types.
-    if (!args[3]->IsInt32() 
+    if (!argv[3]->IsInt32() 
         && !jsValue->IsUndefined() // Not data-at-execution
         && (sqlType == SQL_BINARY || sqlType == SQL_CHAR)) {
 
         if (param->Length() > SHRT_MAX)
-            return NanThrowError("Parameter data is too big to be passed as SQL_BINARY or SQL_VARCHAR");
+            return NanError("Parameter data is too big to be passed as SQL_BINARY or SQL_VARCHAR");
 
         columnSize = param->Length();
     }
 
-    auto ret = SQLBindParameter(
-        GetHandle(),
-        parameterNumber,
-        inOutType,
-        param->CType(),
-        param->SQLType(),
-        columnSize,
-        decimalDigits,
-        param->Buffer(),
-        param->Length(),
-        &param->Indicator());
+    if (!SQL_SUCCEEDED(param->Bind(GetHandle(), columnSize)))
+        return GetLastError();
 
-    if (!SQL_SUCCEEDED(ret))
-        return NanThrowError(GetLastError());
-  
     Statement::AddBoundParameter(param);
 
-    EosMethodReturnValue(jsParam);
+    return Handle<Value>();
+}
+
+// Binds every parameter at once, numbered from 1, from an array of objects
+// with the arguments of bindParameter as properties. A missing value is null
+// rather than data-at-execution.
+NAN_METHOD(Statement::BindParameters) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1 || !args[0]->IsArray())
+        return NanThrowTypeError("The 1st argument should be an array of parameter descriptions");
+
+    if (IsRunning())
+        return NanThrowError("Cannot bind parameters while an operation is in progress");
+
+    auto descriptions = args[0].As<Array>();
+    if (descriptions->Length() > USHRT_MAX)
+        return NanThrowRangeError("There are too many parameters");
+
+    auto kKind = NanSymbol("kind");
+    auto kType = NanSymbol("type");
+    auto kColumnSize = NanSymbol("columnSize");
+    auto kDecimalDigits = NanSymbol("decimalDigits");
+    auto kValue = NanSymbol("value");
+    auto kBuffer = NanSymbol("buffer");
+
+    auto result = NanNew<Array>(descriptions->Length());
+
+    for (uint32_t i = 0; i < descriptions->Length(); i++) {
+        auto description = descriptions->Get(i);
+        if (!description->IsObject())
+            return NanThrowTypeError("Every parameter description should be an object");
+
+        auto obj = description.As<Object>();
+
+        Handle<Value> kind = obj->Get(kKind);
+        if (kind->IsUndefined())
+            kind = NanNew<Integer>(SQL_PARAM_INPUT);
+
+        Handle<Value> value = obj->Get(kValue);
+        if (value->IsUndefined())
+            value = NanNull();
+
+        Handle<Value> argv[] = {
+            NanNew<Integer>(static_cast<int32_t>(i + 1)),
+            kind,
+            obj->Get(kType),
+            obj->Get(kColumnSize),
+            obj->Get(kDecimalDigits),
+            value,
+            obj->Get(kBuffer)
+        };
+
+        Local<Object> jsParam;
+        auto error = BindOneParameter(7, argv, jsParam);
+        if (!error.IsEmpty())
+            return NanThrowError(error);
+
+        result->Set(i, jsParam);
+    }
+
+    EosMethodReturnValue(result);
 }
 
 void Statement::AddBoundParameter(Parameter* param) {
@@ -205,15 +324,37 @@ void Statement::AddBoundParameter(Parameter* param) {
     if (bindings_.IsEmpty())
         NanAssignPersistent(bindings_, NanNew<Array>());
 
+    // A parameter bound again with the same number replaces the old one
+    for (auto it = boundParameters_.begin(); it != boundParameters_.end(); ++it) {
+        if ((*it)->ParameterNumber() == param->ParameterNumber()) {
+            (*it)->SetStatement(nullptr);
+            boundParameters_.erase(it);
+            break;
+        }
+    }
+
+    param->SetStatement(this);
+    boundParameters_.push_back(param);
+
     NanNew(bindings_)->Set(param->ParameterNumber(), NanObjectWrapHandle(param));
 }
 
+// Parameters can outlive the statement, if JS still refers to them.
+void Statement::ReleaseBoundParameters() {
+    for (auto it = boundParameters_.begin(); it != boundParameters_.end(); ++it)
+        (*it)->SetStatement(nullptr);
+    boundParameters_.clear();
+}
+
 NAN_METHOD(Statement::SetParameterName) {
     EOS_DEBUG_METHOD();
 
     if (args.Length() != 2)
         return NanThrowError("Statement::SetParameterName requires 2 arguments");
 
+    if (IsRunning())
+        return NanThrowError("Cannot name parameters while an operation is in progress");
+
     if (!args[0]->IsInt32())
         return NanThrowError("The parameter number must be an integer");
 
@@ -262,17 +403,102 @@ Parameter* Statement::GetBoundParameter(SQLUSMALLINT parameterNumber) {
 NAN_METHOD(Statement::UnbindParameters) {
     EOS_DEBUG_METHOD();
 
+    if (IsRunning())
+        return NanThrowError("Cannot unbind parameters while an operation is in progress");
+
     if(!SQL_SUCCEEDED(SQLFreeStmt(GetHandle(), SQL_RESET_PARAMS)))
         return NanThrowError(GetLastError());
 
+    ReleaseBoundParameters();
     NanDisposePersistent(bindings_);
 
     NanReturnUndefined();
 }
 
+NAN_METHOD(Statement::BindColumn) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 2)
+        return NanThrowError("BindColumn expects 2 or 3 arguments");
+
+    if (IsRunning())
+        return NanThrowError("Cannot bind columns while an operation is in progress");
+
+    if (!args[0]->IsInt32())
+        return NanThrowTypeError("The 1st argument should be an integer");
+
+    if (!args[1]->IsInt32())
+        return NanThrowTypeError("The 2nd argument should be an integer");
+
+    // 0. column number (e.g. 1)
+    // 1. SQL type (e.g. SQL_INTEGER)
+    // 2. buffer size in bytes, for variable-length types (e.g. 512)
+
+    auto columnNumber = args[0]->Int32Value();
+    if (columnNumber < 1 || columnNumber > USHRT_MAX)
+        return NanThrowError("The column number is incorrect (valid values: 1 - 65535)");
+
+    SQLSMALLINT sqlType = args[1]->Int32Value();
+
+    // The same default as getData uses when no buffer is given
+    SQLLEN bufferLength = 65536;
+    if (args.Length() >= 3 && !args[2]->IsUndefined() && !args[2]->IsNull()) {
+        if (!args[2]->IsUint32())
+            return NanThrowTypeError("The 3rd argument should be a positive integer");
+        bufferLength = args[2]->Uint32Value();
+    }
+
+    Local<Object> jsColumn;
+    if (auto msg = Column::Allocate(Pool(), columnNumber, sqlType, bufferLength, jsColumn))
+        return NanThrowError(msg);
+
+    auto column = Column::Unwrap(jsColumn);
+
+    auto ret = SQLBindCol(
+        GetHandle(),
+        columnNumber,
+        column->CType(),
+        column->Buffer(),
+        column->Length(),
+        &column->Indicator());
+
+    if (!SQL_SUCCEEDED(ret))
+        return NanThrowError(GetLastError());
+
+    if (columns_.IsEmpty())
+        NanAssignPersistent(columns_, NanNew<Array>());
+
+    // Replaces any previous binding of the same column, just like SQLBindCol
+    NanNew(columns_)->Set(columnNumber, jsColumn);
+
+    EosMethodReturnValue(jsColumn);
+}
+
+NAN_METHOD(Statement::UnbindColumns) {
+    EOS_DEBUG_METHOD();
+
+    if (IsRunning())
+        return NanThrowError("Cannot unbind columns while an operation is in progress");
+
+    if(!SQL_SUCCEEDED(SQLFreeStmt(GetHandle(), SQL_UNBIND)))
+        return NanThrowError(GetLastError());
+
+    NanDisposePersistent(columns_);
+
+    NanReturnUndefined();
+}
+
 NAN_METHOD(Statement::CloseCursor) {
     EOS_DEBUG_METHOD();
 
+    // If the next block is still being fetched, the cursor is closed when
+    // it arrives
+    if (!StopReadAhead(CloseAfterReadAhead))
+        NanReturnUndefined();
+
+    if (IsRunning())
+        return NanThrowError("Cannot close the cursor while an operation is in progress");
+
     SQLRETURN ret;
     if (args.Length() > 0 && args[0]->IsTrue())
         ret = SQLCloseCursor(GetHandle()); // Can fail if no open cursor
@@ -285,8 +511,108 @@ NAN_METHOD(Statement::CloseCursor) {
     NanReturnUndefined();
 }
 
+NAN_METHOD(Statement::SetTimestampMode) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1 || !args[0]->IsString())
+        return NanThrowTypeError("The 1st argument should be 'local', 'utc' or 'number'");
+
+    auto mode = args[0].As<String>();
+    if (mode->Equals(NanNew<String>("local")))
+        options_.timestamps = TimestampLocalDate;
+    else if (mode->Equals(NanNew<String>("utc")))
+        options_.timestamps = TimestampUTCDate;
+    else if (mode->Equals(NanNew<String>("number")))
+        options_.timestamps = TimestampNumber;
+    else
+        return NanThrowError("The timestamp mode must be 'local', 'utc' or 'number'");
+
+    NanReturnUndefined();
+}
+
+NAN_METHOD(Statement::SetNumericMode) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1 || !args[0]->IsString())
+        return NanThrowTypeError("The 1st argument should be 'number' or 'string'");
+
+    auto mode = args[0].As<String>();
+    if (mode->Equals(NanNew<String>("number")))
+        options_.numerics = NumericNumber;
+    else if (mode->Equals(NanNew<String>("string")))
+        options_.numerics = NumericString;
+    else
+        return NanThrowError("The numeric mode must be 'number' or 'string'");
+
+    NanReturnUndefined();
+}
+
+NAN_METHOD(Statement::SetRowMode) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1 || !args[0]->IsString())
+        return NanThrowTypeError("The 1st argument should be 'array' or 'object'");
+
+    auto mode = args[0].As<String>();
+    if (mode->Equals(NanNew<String>("array")))
+        options_.rows = RowArray;
+    else if (mode->Equals(NanNew<String>("object")))
+        options_.rows = RowObject;
+    else
+        return NanThrowError("The row mode must be 'array' or 'object'");
+
+    NanReturnUndefined();
+}
+
+bool Statement::CanRecycle() const {
+    return IsValid()
+        && !prepared_
+        && generation_ == connection_->Generation()
+        && connection_->CanRecycleStatementHandles();
+}
+
+SQLRETURN Statement::ResetHandle(SQLHSTMT hStmt) {
+    auto ret = SQLFreeStmt(hStmt, SQL_CLOSE);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    ret = SQLFreeStmt(hStmt, SQL_UNBIND);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+
+    return SQLFreeStmt(hStmt, SQL_RESET_PARAMS);
+}
+
+// Gives the handle back to the connection instead of freeing it.
+bool Statement::Recycle() {
+    EOS_DEBUG_METHOD();
+
+    if (!CanRecycle() || !SQL_SUCCEEDED(ResetHandle(GetHandle())))
+        return false;
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    HANDLE hEvent;
+    auto hStmt = DetachHandle(hEvent);
+    connection_->ReturnStatementHandle(hStmt, hEvent);
+#else
+    connection_->ReturnStatementHandle(DetachHandle());
+#endif
+
+    return true;
+}
+
 Statement::~Statement() {
     EOS_DEBUG_METHOD();
+
+    // Handles are only recycled by free(). Resetting one here would make
+    // blocking ODBC calls (SQL_CLOSE can go to the server) during garbage
+    // collection, so the handle is just freed.
+
+    ReleaseBoundParameters();
+
+    pool_->Release();
+    NanDisposePersistent(readAhead_);
+    NanDisposePersistent(connectionObject_);
 }
 
 #if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
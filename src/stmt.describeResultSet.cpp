@@ -0,0 +1,98 @@
+#include "stmt.hpp"
+#include "result.hpp"
+#include "metadata.hpp"
+
+#include <vector>
+
+using namespace Eos;
+
+namespace Eos {
+    // Describes every column of the current result set in one go on the
+    // thread pool, instead of a numResultCols call followed by a describeCol
+    // call for each column. If the prepared statement's metadata was cached,
+    // the driver isn't asked at all.
+    struct DescribeResultSetOperation : Operation<Statement, DescribeResultSetOperation> {
+        DescribeResultSetOperation()
+            : described_(nullptr)
+        {
+            EOS_DEBUG_METHOD();
+        }
+
+        static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
+            EOS_DEBUG_METHOD();
+
+            if (args.Length() < 2)
+                return NanError("Too few arguments");
+
+            auto op = new DescribeResultSetOperation();
+            op->Wrap(args.Holder());
+
+            EOS_OPERATION_CONSTRUCTOR_RETURN();
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            if (!SQL_SUCCEEDED(ret))
+                return CallbackErrorOverride(ret);
+
+            EOS_DEBUG(L"Final Result: %hi\n", ret);
+
+            Handle<Value> argv[] = { NanUndefined(), ColumnAttributesToJS(described_ ? *described_ : columns_) };
+            columns_.clear();
+
+            MakeCallback(argv);
+        }
+
+        static const char* Name() { return "DescribeResultSetOperation"; }
+
+    protected:
+        SQLRETURN CallOverride() {
+            EOS_DEBUG_METHOD();
+
+            // Still valid in the callback, since only a prepare's callback
+            // replaces the statement's metadata
+            described_ = Owner()->CurrentColumns();
+            if (described_)
+                return SQL_SUCCESS;
+
+            auto hStmt = Owner()->GetHandle();
+
+            SQLSMALLINT columnCount;
+            auto ret = SQLNumResultCols(hStmt, &columnCount);
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+
+            columns_.resize(columnCount);
+            for (SQLSMALLINT i = 0; i < columnCount; i++) {
+                ret = columns_[i].Describe(hStmt, i + 1);
+                if (!SQL_SUCCEEDED(ret))
+                    return ret;
+            }
+
+            return SQL_SUCCESS;
+        }
+
+    private:
+        std::vector<ColumnAttributes> columns_;
+        const std::vector<ColumnAttributes>* described_;
+    };
+}
+
+NAN_METHOD(Statement::DescribeResultSet) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1)
+        return NanThrowError("Statement::DescribeResultSet() requires a callback");
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    if (GetEventHandle())
+        return NanThrowError("describeResultSet is not supported with asynchronous notifications");
+#endif
+
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[0] };
+    return Begin<DescribeResultSetOperation>(argv);
+}
+
+template<> Persistent<FunctionTemplate> Operation<Statement, DescribeResultSetOperation>::constructor_ = Persistent<FunctionTemplate>();
+namespace { ClassInitializer<DescribeResultSetOperation> ci; }
@@ -26,10 +26,18 @@ namespace Eos {
 
         static const char* Name() { return "ExecDirectOperation"; }
 
+        // Output parameters are read after the callback, so another execute
+        // mustn't overwrite them first
+        bool ChainsOnWorker() { return !Owner()->HasBoundParameters(); }
+
     protected:
         SQLRETURN CallOverride() {
             EOS_DEBUG_METHOD();
 
+            // Any prepared statement is replaced (its metadata is left for the
+            // next prepare to replace, since only the main thread can release it)
+            Owner()->SetPrepared(false);
+
             return SQLExecDirectW(
                 Owner()->GetHandle(), 
                 *sql_, sql_.length());
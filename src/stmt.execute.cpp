@@ -1,4 +1,5 @@
 #include "stmt.hpp"
+#include "parameter.hpp"
 
 using namespace Eos;
 
@@ -21,10 +22,16 @@ namespace Eos {
 
         static const char* Name() { return "ExecuteOperation"; }
 
+        // Output parameters are read after the callback, so another execute
+        // mustn't overwrite them first
+        bool ChainsOnWorker() { return !Owner()->HasBoundParameters(); }
+
     protected:
         SQLRETURN CallOverride() {
             EOS_DEBUG_METHOD();
 
+            Owner()->SetFirstResultSet(true);
+
             return SQLExecute(Owner()->GetHandle());
         }
 
@@ -57,5 +64,43 @@ NAN_METHOD(Statement::Execute) {
     return Begin<ExecuteOperation>(argv);
 }
 
+// Gives the bound parameters new values in one call, writing them straight
+// into the bound buffers, and executes the statement.
+NAN_METHOD(Statement::ExecuteWith) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 2)
+        return NanThrowError("Statement::ExecuteWith() requires an array of values and a callback");
+
+    if (!args[0]->IsArray())
+        return NanThrowTypeError("The values should be an array");
+
+    // The values go straight into the bound buffers, so they can't wait in
+    // the queue behind an operation which may be using them
+    if (IsRunning())
+        return NanThrowError("An operation is already in progress on this handle.");
+
+    auto values = args[0].As<Array>();
+    if (values->Length() > USHRT_MAX)
+        return NanThrowRangeError("There are too many values");
+
+    for (uint32_t i = 0; i < values->Length(); i++) {
+        auto param = GetBoundParameter(static_cast<SQLUSMALLINT>(i + 1));
+        if (!param)
+            return NanThrowError("Every value should have a bound parameter");
+
+        bool rebind;
+        if (auto msg = param->Assign(values->Get(i), rebind))
+            return NanThrowError(msg);
+
+        // The buffer was replaced
+        if (rebind && !SQL_SUCCEEDED(param->Rebind(GetHandle())))
+            return NanThrowError(GetLastError());
+    }
+
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[1] };
+    return Begin<ExecuteOperation>(argv);
+}
+
 template<> Persistent<FunctionTemplate> Operation<Statement, ExecuteOperation>::constructor_ = Persistent<FunctionTemplate>();
 namespace { ClassInitializer<ExecuteOperation> ci; }
@@ -0,0 +1,688 @@
+#include "stmt.hpp"
+#include "buffer.hpp"
+#include "numeric.hpp"
+#include "metadata.hpp"
+
+#include <cstdio>
+#include <vector>
+
+using namespace Eos;
+
+namespace Eos {
+    // Executes a prepared statement once for a whole array of parameter sets,
+    // bound column-wise (SQL_PARAM_BIND_BY_COLUMN), so that inserting many
+    // rows takes one round trip instead of one per row. The values are
+    // marshalled into native arrays on the main thread (except for typed
+    // arrays, whose memory is bound as it is); binding, executing, and
+    // unbinding the arrays all happen on the thread pool.
+    struct ExecuteBatchOperation : Operation<Statement, ExecuteBatchOperation> {
+        // The values of one parameter for every parameter set.
+        struct ParameterArray {
+            SQLSMALLINT sqlType, cType;
+            SQLULEN columnSize;
+            SQLSMALLINT decimalDigits;
+            SQLLEN width; // Bytes per element
+            std::vector<char> data;
+            std::vector<SQLLEN> indicators;
+
+            // The memory of a typed array, used instead of data, and its null
+            // mask (one bit per row), which is expanded into the indicators
+            // on the thread pool. Both are pinned by the operation.
+            char* external;
+            const unsigned char* nullMask;
+
+            char* Data() { return external ? external : &data[0]; }
+            SQLLEN* Indicators() { return indicators.empty() ? nullptr : &indicators[0]; }
+        };
+
+        // A diagnostic record, read on the thread pool.
+        struct Diagnostic {
+            SQLLEN rowNumber;
+            std::vector<SQLWCHAR> state, message;
+        };
+
+        ExecuteBatchOperation(std::vector<ParameterArray>& parameters, SQLULEN rowCount, Handle<Array> pinned)
+            : rowCount_(rowCount)
+            , processed_(0)
+            , rowsAffected_(-1)
+            , status_(rowCount, SQL_PARAM_UNUSED)
+        {
+            EOS_DEBUG_METHOD_FMT(L"%lu rows", static_cast<unsigned long>(rowCount));
+
+            parameters_.swap(parameters);
+            NanAssignPersistent(pinned_, pinned);
+        }
+
+        ~ExecuteBatchOperation() {
+            NanDisposePersistent(pinned_);
+        }
+
+        static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
+            EOS_DEBUG_METHOD();
+
+            if (args.Length() < 3)
+                return NanError("Too few arguments");
+
+            if (!args[1]->IsArray())
+                return NanTypeError("The parameter values should be an array of rows or an array of columns");
+
+            // Marshal before creating the operation, which can't be destroyed
+            // without having run.
+            std::vector<ParameterArray> parameters;
+            SQLULEN rowCount;
+            auto pinned = NanNew<Array>();
+            // The metadata can't be relied on while operations ahead of this one
+            // (e.g. a prepare) may still change it
+            auto metadata = owner->IsRunning() ? nullptr : owner->PreparedMetadata();
+            auto error = Marshal(args[1].As<Array>(), metadata, parameters, rowCount, pinned);
+            if (!error->IsUndefined())
+                return error;
+
+            (new ExecuteBatchOperation(parameters, rowCount, pinned))->Wrap(args.Holder());
+
+            EOS_OPERATION_CONSTRUCTOR_RETURN();
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            EOS_DEBUG(L"Final Result: %hi, %lu processed\n", ret, static_cast<unsigned long>(processed_));
+
+            auto diagnostics = NanNew<Array>(static_cast<int>(diagnostics_.size()));
+            for (size_t i = 0; i < diagnostics_.size(); i++)
+                diagnostics->Set(static_cast<uint32_t>(i), DiagnosticToJS(diagnostics_[i]));
+
+            auto status = NanNew<Array>(static_cast<int>(rowCount_));
+            double failed = 0;
+            for (SQLULEN i = 0; i < rowCount_; i++) {
+                status->Set(static_cast<uint32_t>(i), NanNew<Integer>(status_[i]));
+                if (status_[i] == SQL_PARAM_ERROR)
+                    failed++;
+            }
+
+            auto result = NanNew<Object>();
+            result->Set(NanSymbol("rowCount"), NanNew<Number>(static_cast<double>(rowsAffected_)));
+            result->Set(NanSymbol("processed"), NanNew<Number>(static_cast<double>(processed_)));
+            result->Set(NanSymbol("failed"), NanNew<Number>(failed));
+            result->Set(NanSymbol("status"), status);
+            result->Set(NanSymbol("diagnostics"), diagnostics);
+
+            Handle<Value> argv[] = { NanUndefined(), result };
+
+            if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA) {
+                argv[0] = diagnostics->Length() > 0
+                    ? diagnostics->Get(0)
+                    : OdbcError("The batch could not be executed");
+            }
+
+            parameters_.clear();
+            diagnostics_.clear();
+
+            MakeCallback(argv);
+        }
+
+        static const char* Name() { return "ExecuteBatchOperation"; }
+
+    protected:
+        SQLRETURN CallOverride() {
+            EOS_DEBUG_METHOD();
+
+            auto hStmt = Owner()->GetHandle();
+            auto ret = BindAndExecute(hStmt);
+
+            // The diagnostics are cleared by the next call on the statement
+            ReadDiagnostics(hStmt);
+
+            if (SQL_SUCCEEDED(ret) || ret == SQL_NO_DATA) {
+                if (!SQL_SUCCEEDED(SQLRowCount(hStmt, &rowsAffected_)))
+                    rowsAffected_ = -1;
+            }
+
+            // Back to binding single parameters
+            SQLFreeStmt(hStmt, SQL_RESET_PARAMS);
+            SQLSetStmtAttrW(hStmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, SQL_IS_UINTEGER);
+            SQLSetStmtAttrW(hStmt, SQL_ATTR_PARAM_STATUS_PTR, nullptr, SQL_IS_POINTER);
+            SQLSetStmtAttrW(hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, nullptr, SQL_IS_POINTER);
+
+            return ret;
+        }
+
+    private:
+        SQLRETURN BindAndExecute(SQLHSTMT hStmt) {
+            auto ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, SQL_IS_UINTEGER);
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+
+            ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)rowCount_, SQL_IS_UINTEGER);
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+
+            ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_PARAM_STATUS_PTR, &status_[0], SQL_IS_POINTER);
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+
+            ret = SQLSetStmtAttrW(hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &processed_, SQL_IS_POINTER);
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+
+            for (size_t i = 0; i < parameters_.size(); i++) {
+                auto& param = parameters_[i];
+                auto parameterNumber = static_cast<SQLUSMALLINT>(i + 1);
+
+                if (param.nullMask) {
+                    param.indicators.resize(static_cast<size_t>(rowCount_));
+                    for (SQLULEN r = 0; r < rowCount_; r++)
+                        param.indicators[r] = (param.nullMask[r >> 3] & (1 << (r & 7))) ? SQL_NULL_DATA : 0;
+                }
+
+                ret = SQLBindParameter(
+                    hStmt,
+                    parameterNumber,
+                    SQL_PARAM_INPUT,
+                    param.cType,
+                    param.sqlType,
+                    param.columnSize,
+                    param.decimalDigits,
+                    param.Data(), param.width,
+                    param.Indicators());
+
+                if (!SQL_SUCCEEDED(ret))
+                    return ret;
+
+                // The precision and scale of SQL_C_NUMERIC values are taken from the APD
+                if (param.cType == SQL_C_NUMERIC) {
+                    ret = Numerics::SetDescriptor(
+                        hStmt, SQL_ATTR_APP_PARAM_DESC, parameterNumber,
+                        static_cast<SQLSMALLINT>(param.columnSize), param.decimalDigits,
+                        param.Data());
+
+                    if (!SQL_SUCCEEDED(ret))
+                        return ret;
+                }
+            }
+
+            return SQLExecute(hStmt);
+        }
+
+        void ReadDiagnostics(SQLHSTMT hStmt) {
+            SQLINTEGER count;
+            if (!SQL_SUCCEEDED(SQLGetDiagFieldW(SQL_HANDLE_STMT, hStmt, 0, SQL_DIAG_NUMBER, &count, SQL_IS_INTEGER, nullptr)))
+                return;
+
+            diagnostics_.resize(count);
+            for (SQLINTEGER i = 0; i < count; i++) {
+                auto& diagnostic = diagnostics_[i];
+                auto record = static_cast<SQLSMALLINT>(i + 1);
+
+                diagnostic.state.resize(6);
+                diagnostic.message.resize(1024 + 1);
+
+                SQLSMALLINT messageLength = 0;
+                auto ret = SQLGetDiagRecW(
+                    SQL_HANDLE_STMT, hStmt, record,
+                    &diagnostic.state[0],
+                    nullptr,
+                    &diagnostic.message[0], static_cast<SQLSMALLINT>(diagnostic.message.size()),
+                    &messageLength);
+
+                if (!SQL_SUCCEEDED(ret)) {
+                    diagnostics_.resize(i);
+                    return;
+                }
+
+                diagnostic.message.resize(min(static_cast<size_t>(messageLength), diagnostic.message.size() - 1) + 1);
+                diagnostic.rowNumber = SQL_ROW_NUMBER_UNKNOWN;
+                SQLGetDiagFieldW(SQL_HANDLE_STMT, hStmt, record, SQL_DIAG_ROW_NUMBER, &diagnostic.rowNumber, 0, nullptr);
+            }
+        }
+
+        // An OdbcError with the index of the parameter set it applies to (or
+        // -1) as its row property.
+        static Handle<Value> DiagnosticToJS(const Diagnostic& diagnostic) {
+            auto error = OdbcError(StringFromTChar(&diagnostic.message[0]), StringFromTChar(&diagnostic.state[0]));
+
+            auto row = diagnostic.rowNumber > 0 ? static_cast<double>(diagnostic.rowNumber - 1) : -1;
+            error.As<Object>()->Set(NanSymbol("row"), NanNew<Number>(row));
+            return error;
+        }
+
+        // What one pass over a parameter's values finds out about them.
+        struct ValueSummary {
+            SQLSMALLINT sqlType; // Inferred, if the type wasn't known
+            SQLLEN maxLength; // Of variable-length values, or -1 if one can't be converted
+            int scale; // The most digits after the point, if asked for
+        };
+
+        static Handle<Value> Marshal(
+            Handle<Array> data,
+            StatementMetadata* metadata,
+            std::vector<ParameterArray>& parameters,
+            SQLULEN& rowCount,
+            Handle<Array> pinned)
+        {
+            if (data->Length() == 0)
+                return NanError("There are no parameter sets to execute");
+
+            // The values of each parameter (except typed arrays), read from
+            // either an array of rows (each an array of parameter values) or
+            // an array of columns (each an object with a values array, and
+            // optionally type, columnSize and decimalDigits) just once.
+            std::vector<std::vector<Local<Value> > > values;
+            std::vector<Local<Object> > columns;
+            std::vector<Local<Object> > specs;
+            uint32_t columnCount;
+
+            auto first = data->Get(0);
+            if (first->IsArray()) {
+                rowCount = data->Length();
+                columnCount = first.As<Array>()->Length();
+                if (columnCount > USHRT_MAX)
+                    return NanError("There are too many parameters");
+
+                values.resize(columnCount, std::vector<Local<Value> >(static_cast<size_t>(rowCount)));
+
+                for (uint32_t r = 0; r < rowCount; r++) {
+                    auto row = data->Get(r);
+                    if (!row->IsArray() || row.As<Array>()->Length() != columnCount)
+                        return NanError("Every row should be an array with the same number of values");
+
+                    auto rowValues = row.As<Array>();
+                    for (uint32_t c = 0; c < columnCount; c++)
+                        values[c][r] = rowValues->Get(c);
+                }
+            } else {
+                columnCount = data->Length();
+                auto kValues = NanSymbol("values");
+
+                for (uint32_t c = 0; c < columnCount; c++) {
+                    auto column = data->Get(c);
+                    if (!column->IsObject())
+                        return NanTypeError("Every column should be an object with a values array");
+
+                    auto columnValues = column.As<Object>()->Get(kValues);
+                    SQLULEN length;
+                    if (columnValues->IsArray())
+                        length = columnValues.As<Array>()->Length();
+                    else if (IsTypedArray(columnValues))
+                        length = columnValues.As<Object>()->GetIndexedPropertiesExternalArrayDataLength();
+                    else
+                        return NanTypeError("Every column should be an object with a values array or typed array");
+
+                    if (c == 0)
+                        rowCount = length;
+                    else if (length != rowCount)
+                        return NanError("Every column should have the same number of values");
+
+                    specs.push_back(column.As<Object>());
+                    columns.push_back(columnValues.As<Object>());
+                }
+
+                values.resize(columnCount);
+                for (uint32_t c = 0; c < columnCount; c++) {
+                    if (IsTypedArray(columns[c]))
+                        continue;
+
+                    values[c].resize(static_cast<size_t>(rowCount));
+                    for (uint32_t r = 0; r < rowCount; r++)
+                        values[c][r] = columns[c]->Get(r);
+                }
+            }
+
+            if (columnCount == 0 || rowCount == 0)
+                return NanError("There are no parameter values to execute");
+
+            if (columnCount > USHRT_MAX)
+                return NanError("There are too many parameters");
+
+            auto kType = NanSymbol("type");
+            auto kColumnSize = NanSymbol("columnSize");
+            auto kDecimalDigits = NanSymbol("decimalDigits");
+
+            parameters.resize(columnCount);
+            for (uint32_t c = 0; c < columnCount; c++) {
+                auto& param = parameters[c];
+
+                // Explicit types and sizes, then the prepared statement's cached
+                // parameter descriptions, then the values themselves.
+                Local<Value> type, columnSize, decimalDigits;
+                if (!specs.empty()) {
+                    type = specs[c]->Get(kType);
+                    columnSize = specs[c]->Get(kColumnSize);
+                    decimalDigits = specs[c]->Get(kDecimalDigits);
+                }
+
+                const ParameterDescription* described = nullptr;
+                if (metadata && metadata->parametersDescribed && c < metadata->parameters.size())
+                    described = &metadata->parameters[c];
+
+                param.external = nullptr;
+                param.nullMask = nullptr;
+
+                if (!columns.empty() && IsTypedArray(columns[c])) {
+                    auto error = MarshalTypedArray(columns[c], specs[c], type, columnSize, decimalDigits, described, rowCount, param, pinned);
+                    if (!error->IsUndefined())
+                        return error;
+                    continue;
+                }
+
+                auto& column = values[c];
+
+                // The C type is known before looking at the values unless the
+                // SQL type has to be inferred from them.
+                param.sqlType = SQL_UNKNOWN_TYPE;
+                if (!type.IsEmpty() && type->IsInt32())
+                    param.sqlType = static_cast<SQLSMALLINT>(type->Int32Value());
+                else if (described && described->dataType != SQL_UNKNOWN_TYPE)
+                    param.sqlType = described->dataType;
+
+                auto knownCType = param.sqlType == SQL_UNKNOWN_TYPE ? 0 : GetCTypeForSQLType(param.sqlType);
+
+                // Without a scale, decimal values would be rounded to integers
+                auto hasDecimalDigits = (!decimalDigits.IsEmpty() && decimalDigits->IsInt32()) || described;
+                auto needScale = knownCType == SQL_C_NUMERIC && !hasDecimalDigits;
+
+                ValueSummary summary;
+                Summarise(column, knownCType, needScale, summary);
+
+                if (param.sqlType == SQL_UNKNOWN_TYPE)
+                    param.sqlType = summary.sqlType;
+
+                param.cType = GetCTypeForSQLType(param.sqlType);
+
+                param.width = Buffers::GetDesiredBufferLength(param.cType);
+                if (param.width == 0)
+                    param.width = summary.maxLength;
+
+                if (param.width < 0)
+                    return NanTypeError("A value could not be converted to its parameter's type");
+
+                if (param.width == 0)
+                    param.width = param.cType == SQL_C_WCHAR ? sizeof(SQLWCHAR) : 1;
+
+                if (!columnSize.IsEmpty() && columnSize->IsUint32())
+                    param.columnSize = columnSize->Uint32Value();
+                else if (described)
+                    param.columnSize = described->parameterSize;
+                else
+                    param.columnSize = GetDefaultColumnSize(param.cType, param.width);
+
+                if (!decimalDigits.IsEmpty() && decimalDigits->IsInt32())
+                    param.decimalDigits = static_cast<SQLSMALLINT>(decimalDigits->Int32Value());
+                else if (described)
+                    param.decimalDigits = described->decimalDigits;
+                else if (needScale)
+                    param.decimalDigits = static_cast<SQLSMALLINT>(summary.scale);
+                else
+                    param.decimalDigits = param.cType == SQL_C_TYPE_TIMESTAMP ? 3 : 0;
+
+                if (static_cast<SQLULEN>(param.width) > static_cast<SQLULEN>(-1) / rowCount)
+                    return NanRangeError("The parameter values are too big");
+
+                param.data.resize(static_cast<size_t>(param.width * rowCount));
+                param.indicators.resize(static_cast<size_t>(rowCount));
+
+                bool variableLength = Buffers::GetDesiredBufferLength(param.cType) == 0;
+                for (uint32_t r = 0; r < rowCount; r++) {
+                    auto value = column[r];
+                    if (value->IsNull() || value->IsUndefined()) {
+                        param.indicators[r] = SQL_NULL_DATA;
+                        continue;
+                    }
+
+                    auto length = Buffers::FillInputBuffer(
+                        param.cType, value,
+                        &param.data[r * param.width], param.width,
+                        param.decimalDigits);
+
+                    if (length == 0 && !variableLength) {
+                        char message[128];
+                        sprintf(message, "Parameter %u of row %u could not be converted to its parameter's type", c + 1, r);
+                        return NanTypeError(message);
+                    }
+
+                    param.indicators[r] = length;
+                }
+            }
+
+            return NanUndefined();
+        }
+
+        static bool IsTypedArray(Handle<Value> value) {
+            return value->IsObject() && value.As<Object>()->HasIndexedPropertiesInExternalArrayData();
+        }
+
+        // Binds the memory of a typed array as the parameter array, without
+        // copying it. The C type follows from the type of the elements; the
+        // SQL type may be given (or described) as usual, and the driver
+        // converts each element. The optional null mask is a Uint8Array with
+        // one bit per row, like the nulls returned by fetchColumns.
+        static Handle<Value> MarshalTypedArray(
+            Handle<Object> array,
+            Handle<Object> spec,
+            Handle<Value> type,
+            Handle<Value> columnSize,
+            Handle<Value> decimalDigits,
+            const ParameterDescription* described,
+            SQLULEN rowCount,
+            ParameterArray& param,
+            Handle<Array> pinned)
+        {
+            SQLSMALLINT defaultType;
+
+            switch (array->GetIndexedPropertiesExternalArrayDataType()) {
+            case kExternalByteArray:
+                param.cType = SQL_C_STINYINT;
+                param.width = sizeof(SQLSCHAR);
+                defaultType = SQL_SMALLINT; // SQL Server's tinyint is unsigned
+                break;
+            case kExternalUnsignedByteArray:
+            case kExternalPixelArray:
+                param.cType = SQL_C_UTINYINT;
+                param.width = sizeof(SQLCHAR);
+                defaultType = SQL_TINYINT;
+                break;
+            case kExternalShortArray:
+                param.cType = SQL_C_SSHORT;
+                param.width = sizeof(SQLSMALLINT);
+                defaultType = SQL_SMALLINT;
+                break;
+            case kExternalUnsignedShortArray:
+                param.cType = SQL_C_USHORT;
+                param.width = sizeof(SQLUSMALLINT);
+                defaultType = SQL_INTEGER;
+                break;
+            case kExternalIntArray:
+                param.cType = SQL_C_SLONG;
+                param.width = sizeof(SQLINTEGER);
+                defaultType = SQL_INTEGER;
+                break;
+            case kExternalUnsignedIntArray:
+                param.cType = SQL_C_ULONG;
+                param.width = sizeof(SQLUINTEGER);
+                defaultType = SQL_BIGINT;
+                break;
+            case kExternalFloatArray:
+                param.cType = SQL_C_FLOAT;
+                param.width = sizeof(SQLREAL);
+                defaultType = SQL_REAL;
+                break;
+            case kExternalDoubleArray:
+                param.cType = SQL_C_DOUBLE;
+                param.width = sizeof(SQLDOUBLE);
+                defaultType = SQL_DOUBLE;
+                break;
+            default:
+                return NanTypeError("Unsupported typed array");
+            }
+
+            if (!type.IsEmpty() && type->IsInt32())
+                param.sqlType = static_cast<SQLSMALLINT>(type->Int32Value());
+            else if (described && described->dataType != SQL_UNKNOWN_TYPE)
+                param.sqlType = described->dataType;
+            else
+                param.sqlType = defaultType;
+
+            if (!columnSize.IsEmpty() && columnSize->IsUint32())
+                param.columnSize = columnSize->Uint32Value();
+            else
+                param.columnSize = described ? described->parameterSize : 0;
+
+            if (!decimalDigits.IsEmpty() && decimalDigits->IsInt32())
+                param.decimalDigits = static_cast<SQLSMALLINT>(decimalDigits->Int32Value());
+            else
+                param.decimalDigits = described ? described->decimalDigits : 0;
+
+            param.external = static_cast<char*>(array->GetIndexedPropertiesExternalArrayData());
+            pinned->Set(pinned->Length(), array);
+
+            auto nulls = spec->Get(NanSymbol("nulls"));
+            if (!nulls->IsUndefined() && !nulls->IsNull()) {
+                if (!IsTypedArray(nulls) || nulls.As<Object>()->GetIndexedPropertiesExternalArrayDataType() != kExternalUnsignedByteArray)
+                    return NanTypeError("The null mask should be a Uint8Array");
+
+                if (static_cast<SQLULEN>(nulls.As<Object>()->GetIndexedPropertiesExternalArrayDataLength()) < (rowCount + 7) / 8)
+                    return NanRangeError("The null mask should have a bit for every row");
+
+                param.nullMask = static_cast<const unsigned char*>(nulls.As<Object>()->GetIndexedPropertiesExternalArrayData());
+                pinned->Set(pinned->Length(), nulls);
+            }
+
+            return NanUndefined();
+        }
+
+        // Makes one pass over the values of a parameter. If cType is 0, the
+        // type is inferred from the first non-null value, except that integers
+        // are widened to doubles if any of the numbers is not an integer.
+        // Values of variable-length types are measured, and if needScale is
+        // set, the scale which numeric values need is found.
+        static void Summarise(const std::vector<Local<Value> >& values, SQLSMALLINT cType, bool needScale, ValueSummary& summary) {
+            summary.sqlType = SQL_UNKNOWN_TYPE;
+            summary.maxLength = 0;
+            summary.scale = 0;
+
+            for (size_t r = 0; r < values.size(); r++) {
+                auto& value = values[r];
+                if (value->IsNull() || value->IsUndefined())
+                    continue;
+
+                if (!cType) {
+                    if (value->IsInt32()) {
+                        if (summary.sqlType == SQL_UNKNOWN_TYPE)
+                            summary.sqlType = SQL_INTEGER;
+                        continue;
+                    }
+
+                    if (value->IsNumber()) {
+                        summary.sqlType = SQL_DOUBLE;
+                        continue;
+                    }
+
+                    // A value which isn't a number decides the type of the
+                    // rest, unless numbers came first (it then fails to convert)
+                    if (summary.sqlType != SQL_UNKNOWN_TYPE)
+                        continue;
+
+                    if (value->IsBoolean())
+                        summary.sqlType = SQL_BIT;
+                    else if (value->IsDate())
+                        summary.sqlType = SQL_TYPE_TIMESTAMP;
+                    else if (Buffer::HasInstance(value) || JSBuffer::HasInstance(value))
+                        summary.sqlType = SQL_VARBINARY;
+                    else
+                        summary.sqlType = SQL_WVARCHAR;
+
+                    cType = GetCTypeForSQLType(summary.sqlType);
+                }
+
+                if (needScale) {
+                    String::Utf8Value str(value);
+                    if (*str)
+                        summary.scale = max(summary.scale, Numerics::GetScale(*str, str.length()));
+                }
+
+                if (Buffers::GetDesiredBufferLength(cType) != 0)
+                    continue;
+
+                SQLLEN length;
+                if (cType == SQL_C_BINARY) {
+                    SQLPOINTER data;
+                    if (!Buffer::HasInstance(value) && !JSBuffer::HasInstance(value)) {
+                        summary.maxLength = -1;
+                        return;
+                    }
+                    if (JSBuffer::Unwrap(value.As<Object>(), data, length)) {
+                        summary.maxLength = -1;
+                        return;
+                    }
+                } else {
+                    auto str = value->ToString();
+                    if (str.IsEmpty()) {
+                        summary.maxLength = -1;
+                        return;
+                    }
+
+                    length = cType == SQL_C_CHAR
+                        ? str->Utf8Length()
+                        : str->Length() * sizeof(SQLWCHAR);
+                }
+
+                summary.maxLength = max(summary.maxLength, length);
+            }
+
+            if (summary.sqlType == SQL_UNKNOWN_TYPE)
+                summary.sqlType = SQL_WVARCHAR;
+
+            // SQL Server's largest scale
+            summary.scale = min(summary.scale, 38);
+        }
+
+        // Sizes which match the values (0 means varchar(max) and the like when
+        // they are too long for SQL Server's non-max types).
+        static SQLULEN GetDefaultColumnSize(SQLSMALLINT cType, SQLLEN width) {
+            switch (cType) {
+            case SQL_C_WCHAR:
+                return width / sizeof(SQLWCHAR) <= 4000 ? width / sizeof(SQLWCHAR) : 0;
+            case SQL_C_CHAR:
+            case SQL_C_BINARY:
+                return width <= 8000 ? width : 0;
+            case SQL_C_NUMERIC:
+                return 38;
+            case SQL_C_TYPE_TIMESTAMP:
+                return 23;
+            default:
+                return 0;
+            }
+        }
+
+        SQLULEN rowCount_, processed_;
+        SQLLEN rowsAffected_;
+        std::vector<SQLUSMALLINT> status_;
+        std::vector<ParameterArray> parameters_;
+        std::vector<Diagnostic> diagnostics_;
+        Persistent<Array> pinned_; // Typed arrays whose memory is bound
+    };
+}
+
+NAN_METHOD(Statement::ExecuteBatch) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 2)
+        return NanThrowError("Statement::ExecuteBatch() requires parameter values and a callback");
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    // Binding the arrays, executing, and unbinding them takes several ODBC
+    // calls, which cannot be completed using a single asynchronous notification.
+    if (GetEventHandle())
+        return NanThrowError("executeBatch is not supported with asynchronous notifications");
+#endif
+
+    // executeBatch binds (and afterwards unbinds) every parameter itself
+    if (HasBoundParameters())
+        return NanThrowError("Cannot use executeBatch while parameters are bound with bindParameter");
+
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[0], args[1] };
+    return Begin<ExecuteBatchOperation>(argv);
+}
+
+template<> Persistent<FunctionTemplate> Operation<Statement, ExecuteBatchOperation>::constructor_ = Persistent<FunctionTemplate>();
+namespace { ClassInitializer<ExecuteBatchOperation> ci; }
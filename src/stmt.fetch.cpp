@@ -37,6 +37,10 @@ namespace Eos {
 
         static const char* Name() { return "FetchOperation"; }
 
+        // The columns bound with bindColumn are read in the callback, and the
+        // next operation could fetch into them
+        bool ChainsOnWorker() { return false; }
+
     protected:
         SQLRETURN CallOverride() {
             EOS_DEBUG_METHOD();
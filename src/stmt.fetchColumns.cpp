@@ -0,0 +1,105 @@
+#include "stmt.hpp"
+#include "result.hpp"
+
+using namespace Eos;
+
+#if defined(NODE_12)
+namespace Eos {
+    struct FetchColumnsOperation : Operation<Statement, FetchColumnsOperation> {
+        FetchColumnsOperation(SQLULEN rowCount)
+            : rowCount_(rowCount)
+        {
+            EOS_DEBUG_METHOD_FMT(L"%lu", static_cast<unsigned long>(rowCount));
+        }
+
+        static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
+            EOS_DEBUG_METHOD();
+
+            if (args.Length() < 3)
+                return NanError("Too few arguments");
+
+            if (!args[1]->IsUint32() || args[1]->Uint32Value() == 0)
+                return NanTypeError("The number of rows must be a positive integer");
+
+            auto op = new FetchColumnsOperation(args[1]->Uint32Value());
+            op->Wrap(args.Holder());
+
+            EOS_OPERATION_CONSTRUCTOR_RETURN();
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            Handle<Value> argv[3];
+
+            if (rowSet_.Error())
+                argv[0] = OdbcError(rowSet_.Error());
+            else if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
+                argv[0] = Owner()->GetLastError();
+
+            EOS_DEBUG(L"Final Result: %hi\n", ret);
+
+            if (argv[0].IsEmpty()) {
+                argv[0] = NanUndefined();
+                rowSet_.SetConversionOptions(Owner()->GetConversionOptions());
+                argv[1] = rowSet_.GetColumns();
+                argv[2] = NanNew<Number>(static_cast<double>(rowSet_.RowsFetched()));
+            } else {
+                argv[1] = argv[2] = NanUndefined();
+            }
+
+            if (!SQL_SUCCEEDED(rowSet_.Unbind(Owner()->GetHandle())) && argv[0]->IsUndefined()) {
+                argv[0] = Owner()->GetLastError();
+                argv[1] = argv[2] = NanUndefined();
+            }
+
+            rowSet_.Release();
+
+            MakeCallback(argv);
+        }
+
+        static const char* Name() { return "FetchColumnsOperation"; }
+
+        // The callback unbinds the row set
+        bool ChainsOnWorker() { return false; }
+
+    protected:
+        SQLRETURN CallOverride() {
+            EOS_DEBUG_METHOD();
+
+            return rowSet_.Fetch(Owner()->GetHandle(), rowCount_, Owner()->CurrentColumns());
+        }
+
+    private:
+        SQLULEN rowCount_;
+        RowSet rowSet_;
+    };
+}
+#endif
+
+NAN_METHOD(Statement::FetchColumns) {
+    EOS_DEBUG_METHOD();
+
+#if defined(NODE_12)
+    if (args.Length() < 2)
+        return NanThrowError("Statement::FetchColumns() requires a number of rows and a callback");
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    if (GetEventHandle())
+        return NanThrowError("fetchColumns is not supported with asynchronous notifications");
+#endif
+
+    if (HasBoundColumns())
+        return NanThrowError("Cannot use fetchColumns while columns are bound with bindColumn");
+
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[0], args[1] };
+    return Begin<FetchColumnsOperation>(argv);
+#else
+    return NanThrowError("fetchColumns requires typed arrays, which are not available in this version of node");
+#endif
+}
+
+#if defined(NODE_12)
+template<> Persistent<FunctionTemplate> Operation<Statement, FetchColumnsOperation>::constructor_ = Persistent<FunctionTemplate>();
+namespace { ClassInitializer<FetchColumnsOperation> ci; }
+#endif
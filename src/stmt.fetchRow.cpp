@@ -0,0 +1,271 @@
+#include "stmt.hpp"
+#include "result.hpp"
+#include "numeric.hpp"
+
+#include <vector>
+
+using namespace Eos;
+
+namespace Eos {
+    // Fetches the next row, and then reads every column of it with SQLGetData,
+    // including all of the chunks of long values, in one go on the thread pool.
+    struct FetchRowOperation : Operation<Statement, FetchRowOperation> {
+        FetchRowOperation() {
+            EOS_DEBUG_METHOD();
+        }
+
+        static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
+            EOS_DEBUG_METHOD();
+
+            if (args.Length() < 2)
+                return NanError("Too few arguments");
+
+            auto op = new FetchRowOperation();
+            op->Wrap(args.Holder());
+
+            EOS_OPERATION_CONSTRUCTOR_RETURN();
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
+                return CallbackErrorOverride(ret);
+
+            EOS_DEBUG(L"Final Result: %hi\n", ret);
+
+            Handle<Value> argv[] = { NanUndefined(), NanUndefined() };
+
+            auto& options = Owner()->GetConversionOptions();
+            if (ret != SQL_NO_DATA && options.rows == RowObject) {
+                auto& shape = Owner()->GetRowShape();
+                DescribeValue describe = { values_ };
+                shape.Update(values_.size(), describe);
+
+                std::vector<Local<String> > names;
+                shape.GetNames(names);
+
+                auto row = shape.NewRow();
+                for (size_t i = 0; i < values_.size(); i++)
+                    row->Set(names[i], GetValue(values_[i], options));
+                argv[1] = row;
+            } else if (ret != SQL_NO_DATA) {
+                auto row = NanNew<Array>(static_cast<int>(values_.size()));
+                for (uint32_t i = 0; i < values_.size(); i++)
+                    row->Set(i, GetValue(values_[i], options));
+                argv[1] = row;
+            }
+
+            values_.clear();
+
+            MakeCallback(argv);
+        }
+
+        static const char* Name() { return "FetchRowOperation"; }
+
+    protected:
+        SQLRETURN CallOverride() {
+            EOS_DEBUG_METHOD();
+
+            auto hStmt = Owner()->GetHandle();
+
+            auto ret = SQLFetch(hStmt);
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+
+            // The columns are only described if the statement's metadata
+            // wasn't cached when it was prepared
+            auto described = Owner()->CurrentColumns();
+
+            SQLSMALLINT columnCount;
+            SQLRETURN ret2;
+            if (described) {
+                columnCount = static_cast<SQLSMALLINT>(described->size());
+            } else {
+                ret2 = SQLNumResultCols(hStmt, &columnCount);
+                if (!SQL_SUCCEEDED(ret2))
+                    return ret2;
+            }
+
+            values_.resize(columnCount);
+            for (SQLSMALLINT i = 0; i < columnCount; i++) {
+                if (described) {
+                    values_[i].desc = (*described)[i].desc;
+                } else {
+                    ret2 = values_[i].desc.Describe(hStmt, i + 1);
+                    if (!SQL_SUCCEEDED(ret2))
+                        return ret2;
+                }
+
+                ret2 = GetData(hStmt, i + 1, values_[i]);
+                if (!SQL_SUCCEEDED(ret2))
+                    return ret2;
+            }
+
+            return ret;
+        }
+
+    private:
+        struct ColumnValue {
+            ColumnDescription desc;
+            SQLSMALLINT cType;
+            SQLLEN indicator;
+            std::vector<char> data;
+        };
+
+        // For RowShape::Update
+        struct DescribeValue {
+            const std::vector<ColumnValue>& values;
+            const ColumnDescription& operator()(size_t i) const { return values[i].desc; }
+        };
+
+        // Reads the whole value of a described column, one chunk at a time.
+        SQLRETURN GetData(SQLHSTMT hStmt, SQLUSMALLINT columnNumber, ColumnValue& value) {
+            EOS_DEBUG_METHOD_FMT(L"%hu", columnNumber);
+
+            auto& desc = value.desc;
+            SQLRETURN ret;
+
+            value.cType = GetCTypeForSQLType(desc.dataType);
+            value.indicator = 0;
+
+            // SQL_C_NUMERIC values are scaled as described in the ARD
+            auto targetType = value.cType;
+            if (value.cType == SQL_C_NUMERIC) {
+                ret = Numerics::SetDescriptor(
+                    hStmt, SQL_ATTR_APP_ROW_DESC, columnNumber,
+                    static_cast<SQLSMALLINT>(desc.columnSize), desc.decimalDigits, nullptr);
+
+                if (SQL_SUCCEEDED(ret))
+                    targetType = SQL_ARD_TYPE;
+                else
+                    targetType = value.cType = SQL_C_DOUBLE;
+            }
+
+            SQLLEN terminatorLength = 0;
+            if (value.cType == SQL_C_WCHAR)
+                terminatorLength = sizeof(SQLWCHAR);
+            else if (value.cType == SQL_C_CHAR)
+                terminatorLength = 1;
+
+            SQLLEN offset = 0;
+            SQLLEN chunkLength = GetColumnBufferLength(value.cType, desc.columnSize);
+
+            for (;;) {
+                // Grow to exactly the size needed, so that a long value's vector
+                // can be handed over to an external string as it is
+                value.data.reserve(offset + chunkLength);
+                value.data.resize(offset + chunkLength);
+
+                SQLLEN indicator;
+                ret = SQLGetData(
+                    hStmt,
+                    columnNumber,
+                    targetType,
+                    &value.data[offset], chunkLength,
+                    &indicator);
+
+                // No more chunks: the previous call returned all of the data
+                if (ret == SQL_NO_DATA && offset > 0)
+                    break;
+
+                if (!SQL_SUCCEEDED(ret))
+                    return ret;
+
+                if (indicator == SQL_NULL_DATA) {
+                    value.indicator = SQL_NULL_DATA;
+                    value.data.clear();
+                    return ret;
+                }
+
+                // Bytes of data (excluding the null terminator) that fit in this chunk
+                auto available = chunkLength - terminatorLength;
+                if (value.cType == SQL_C_WCHAR)
+                    available &= ~static_cast<SQLLEN>(1);
+
+                if (indicator != SQL_NO_TOTAL && indicator <= available) {
+                    // This was the last chunk (or the only one)
+                    offset += indicator;
+                    break;
+                }
+
+                // SQLSTATE 01004 (string data, right truncated): fetch the rest.
+                offset += available;
+                chunkLength = indicator == SQL_NO_TOTAL
+                    ? chunkLength * 2
+                    : indicator - available + terminatorLength;
+            }
+
+            value.indicator = offset;
+            value.data.resize(offset);
+            return SQL_SUCCESS;
+        }
+
+        static Handle<Value> GetValue(ColumnValue& value, const ConversionOptions& options) {
+            if (value.indicator == SQL_NULL_DATA)
+                return NanNull();
+
+            auto length = value.indicator;
+            if (length == 0 && (value.cType == SQL_C_CHAR || value.cType == SQL_C_WCHAR))
+                return NanNew<String>("");
+
+            static const char empty = 0;
+            auto data = length > 0 ? &value.data[0] : &empty;
+
+            switch (value.cType) {
+            case SQL_C_BINARY:
+                return NanNewBufferHandle(data, static_cast<uint32_t>(length));
+
+            case SQL_C_CHAR:
+                return NanNew<String>(data, static_cast<int>(length));
+
+            case SQL_C_WCHAR: {
+                auto chars = static_cast<size_t>(length) / sizeof(SQLWCHAR);
+                if (chars < ExternalStringThreshold)
+                    return StringFromTChar(reinterpret_cast<const SQLWCHAR*>(data), static_cast<int>(chars));
+
+                // Long values become external strings which keep the data
+                auto owned = new std::vector<char>();
+                owned->swap(value.data);
+
+                BufferOwnership ownership(&DeleteData, owned, owned->capacity());
+                auto str = StringFromTChar(reinterpret_cast<const SQLWCHAR*>(&(*owned)[0]), chars, &ownership);
+                if (!ownership.taken)
+                    delete owned;
+                return str;
+            }
+
+            default:
+                return ConvertToJS(const_cast<char*>(data), length, length, value.cType, nullptr, options);
+            }
+        }
+
+        static void DeleteData(void* data) {
+            delete static_cast<std::vector<char>*>(data);
+        }
+
+        std::vector<ColumnValue> values_;
+    };
+}
+
+NAN_METHOD(Statement::FetchRow) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 1)
+        return NanThrowError("Statement::FetchRow() requires a callback");
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    if (GetEventHandle())
+        return NanThrowError("fetchRow is not supported with asynchronous notifications");
+#endif
+
+    // Bound columns can't be read with SQLGetData
+    if (HasBoundColumns())
+        return NanThrowError("Cannot use fetchRow while columns are bound with bindColumn");
+
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[0] };
+    return Begin<FetchRowOperation>(argv);
+}
+
+template<> Persistent<FunctionTemplate> Operation<Statement, FetchRowOperation>::constructor_ = Persistent<FunctionTemplate>();
+namespace { ClassInitializer<FetchRowOperation> ci; }
@@ -0,0 +1,102 @@
+#include "stmt.hpp"
+#include "result.hpp"
+
+using namespace Eos;
+
+namespace Eos {
+    struct FetchRowsOperation : Operation<Statement, FetchRowsOperation> {
+        FetchRowsOperation(SQLULEN rowCount)
+            : rowCount_(rowCount)
+        {
+            EOS_DEBUG_METHOD_FMT(L"%lu", static_cast<unsigned long>(rowCount));
+        }
+
+        static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
+            EOS_DEBUG_METHOD();
+
+            if (args.Length() < 3)
+                return NanError("Too few arguments");
+
+            if (!args[1]->IsUint32() || args[1]->Uint32Value() == 0)
+                return NanTypeError("The number of rows must be a positive integer");
+
+            auto op = new FetchRowsOperation(args[1]->Uint32Value());
+            op->Wrap(args.Holder());
+
+            EOS_OPERATION_CONSTRUCTOR_RETURN();
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            Handle<Value> argv[2];
+
+            if (rowSet_.Error())
+                argv[0] = OdbcError(rowSet_.Error());
+            else if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
+                argv[0] = Owner()->GetLastError();
+
+            EOS_DEBUG(L"Final Result: %hi\n", ret);
+
+            if (argv[0].IsEmpty()) {
+                argv[0] = NanUndefined();
+                rowSet_.SetConversionOptions(Owner()->GetConversionOptions());
+                argv[1] = ret == SQL_NO_DATA ? NanNew<Array>() : rowSet_.GetRows(Owner()->GetRowShape());
+            } else {
+                argv[1] = NanUndefined();
+            }
+
+            // Put the statement back into single-row mode now that the values
+            // have been converted (and any error has been retrieved, since this
+            // clears the diagnostic records).
+            if (!SQL_SUCCEEDED(rowSet_.Unbind(Owner()->GetHandle())) && argv[0]->IsUndefined()) {
+                argv[0] = Owner()->GetLastError();
+                argv[1] = NanUndefined();
+            }
+
+            rowSet_.Release();
+
+            MakeCallback(argv);
+        }
+
+        static const char* Name() { return "FetchRowsOperation"; }
+
+        // The callback unbinds the row set
+        bool ChainsOnWorker() { return false; }
+
+    protected:
+        SQLRETURN CallOverride() {
+            EOS_DEBUG_METHOD();
+
+            return rowSet_.Fetch(Owner()->GetHandle(), rowCount_, Owner()->CurrentColumns());
+        }
+
+    private:
+        SQLULEN rowCount_;
+        RowSet rowSet_;
+    };
+}
+
+NAN_METHOD(Statement::FetchRows) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 2)
+        return NanThrowError("Statement::FetchRows() requires a number of rows and a callback");
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    // Fetching a block of rows takes several ODBC calls, which cannot be
+    // completed using a single asynchronous notification.
+    if (GetEventHandle())
+        return NanThrowError("fetchRows is not supported with asynchronous notifications");
+#endif
+
+    // fetchRows binds (and afterwards unbinds) every column itself
+    if (HasBoundColumns())
+        return NanThrowError("Cannot use fetchRows while columns are bound with bindColumn");
+
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[0], args[1] };
+    return Begin<FetchRowsOperation>(argv);
+}
+
+template<> Persistent<FunctionTemplate> Operation<Statement, FetchRowsOperation>::constructor_ = Persistent<FunctionTemplate>();
+namespace { ClassInitializer<FetchRowsOperation> ci; }
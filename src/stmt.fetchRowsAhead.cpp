@@ -0,0 +1,318 @@
+#include "stmt.hpp"
+#include "result.hpp"
+
+using namespace Eos;
+
+namespace Eos {
+    // Reads a result set in blocks of rows using two sets of column arrays, so
+    // that the next block is fetched on the thread pool while the previous one
+    // is converted and processed in JavaScript.
+    //
+    // Unlike other operations, a ReadAheadOperation runs once per block (see
+    // RunOnThreadPoolAgain) and lives until the end of the result set, held by
+    // the statement's readAhead_ handle. A block may complete before anybody
+    // has asked for it, in which case it waits in its arrays until the next
+    // call to fetchRowsAhead.
+    //
+    // Every block goes through the statement's queue, so the statement is
+    // running while it is fetched. The statement lets go of the operation at
+    // the end of the result set or on an error, and the operation doesn't keep
+    // the statement alive between blocks (see ReleaseOwner).
+    struct ReadAheadOperation : Operation<Statement, ReadAheadOperation> {
+        ReadAheadOperation(SQLULEN rowCount)
+            : rowCount_(rowCount)
+            , current_(0)
+            , lastResult_(SQL_SUCCESS)
+            , waiting_(true)
+            , ready_(false)
+            , finished_(false)
+            , stop_(Statement::KeepReadingAhead)
+        {
+            EOS_DEBUG_METHOD_FMT(L"%lu", static_cast<unsigned long>(rowCount));
+        }
+
+        ~ReadAheadOperation() {
+            NanDisposePersistent(freeCallback_);
+        }
+
+        static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
+            EOS_DEBUG_METHOD();
+
+            if (args.Length() < 3)
+                return NanError("Too few arguments");
+
+            if (!args[1]->IsUint32() || args[1]->Uint32Value() == 0)
+                return NanTypeError("The number of rows must be a positive integer");
+
+            auto op = new ReadAheadOperation(args[1]->Uint32Value());
+            op->Wrap(args.Holder());
+            owner->SetReadAhead(args.Holder());
+
+            EOS_OPERATION_CONSTRUCTOR_RETURN();
+        }
+
+        static const char* Name() { return "ReadAheadOperation"; }
+
+        // The callback uses the handle (for errors, and to unbind at the end)
+        bool ChainsOnWorker() { return false; }
+
+        // True while a block is being fetched on the thread pool (or is
+        // waiting in the queue to be).
+        bool IsFetching() const { return !IsCompleted(); }
+        bool IsFinished() const { return finished_; }
+        bool IsStopping() const { return stop_ != Statement::KeepReadingAhead; }
+        Statement::ReadAheadStop GetStop() const { return stop_; }
+
+        // Asks for the next block. Returns an error message if one has already
+        // been asked for.
+        const char* Next(Handle<Function> callback) {
+            EOS_DEBUG_METHOD();
+
+            assert(!finished_);
+
+            if (waiting_)
+                return "The next block of rows has already been requested";
+
+            NanAssignPersistent(callback_, callback);
+
+            if (!ready_) {
+                // Still fetching; CallbackOverride will deliver it
+                waiting_ = true;
+                return nullptr;
+            }
+
+            ready_ = false;
+
+            Handle<Value> argv[2];
+            Deliver(argv);
+            CallbackOnNextTick(callback, 2, argv);
+            return nullptr;
+        }
+
+        // Stops reading ahead, e.g. because the cursor is being closed. Only
+        // valid while no block is being fetched.
+        void Stop() {
+            EOS_DEBUG_METHOD();
+
+            assert(!IsFetching());
+            Finish();
+        }
+
+        // Stops reading ahead once the block being fetched has arrived, and
+        // then closes the cursor or frees the statement. The block is thrown
+        // away; a fetchRowsAhead waiting for it gets an empty array.
+        void StopWhenFetched(Statement::ReadAheadStop stop, Handle<Value> freeCallback) {
+            EOS_DEBUG_METHOD();
+
+            assert(IsFetching());
+
+            if (stop > stop_)
+                stop_ = stop;
+
+            if (stop == Statement::FreeAfterReadAhead && freeCallback->IsFunction())
+                NanAssignPersistent(freeCallback_, freeCallback.As<Function>());
+        }
+
+        // The first block can wait in the queue behind other operations
+        void CancelQueued(Handle<Value> error) {
+            EOS_DEBUG_METHOD();
+
+            // Nothing has been bound yet, and the handle may be in use
+            finished_ = true;
+            Owner()->SetReadAhead(Handle<Object>());
+
+            Operation<Statement, ReadAheadOperation>::CancelQueued(error);
+        }
+
+    protected:
+        SQLRETURN CallOverride() {
+            EOS_DEBUG_METHOD();
+
+            return rowSets_[current_].Fetch(Owner()->GetHandle(), rowCount_, Owner()->CurrentColumns());
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            lastResult_ = ret;
+
+            if (IsStopping())
+                return Stopped();
+
+            if (!waiting_) {
+                ready_ = true;
+                return CompleteWithoutCallback();
+            }
+
+            waiting_ = false;
+
+            Handle<Value> argv[2];
+            Deliver(argv);
+            MakeCallback(argv);
+        }
+
+    private:
+        // Starts fetching the next block (if there is one) into the other set
+        // of arrays, and then converts the block which has just been fetched.
+        void Deliver(Handle<Value> (&argv)[2]) {
+            auto& rowSet = rowSets_[current_];
+            auto ret = lastResult_;
+
+            argv[0] = NanUndefined();
+            argv[1] = NanUndefined();
+
+            if (rowSet.Error())
+                argv[0] = OdbcError(rowSet.Error());
+            else if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
+                argv[0] = Owner()->GetLastError();
+
+            if (!argv[0]->IsUndefined() || ret == SQL_NO_DATA) {
+                Finish();
+                if (argv[0]->IsUndefined())
+                    argv[1] = NanNew<Array>();
+                return;
+            }
+
+            current_ ^= 1;
+            RunOnThreadPoolAgain();
+
+            // The driver is now writing to the other arrays
+            rowSet.SetConversionOptions(Owner()->GetConversionOptions());
+            argv[1] = rowSet.GetRows(Owner()->GetRowShape());
+        }
+
+        // The block which has just arrived was fetched after closeCursor or
+        // free asked to stop.
+        void Stopped() {
+            EOS_DEBUG_METHOD();
+
+            Finish();
+
+            auto owner = Owner();
+            if (stop_ == Statement::CloseAfterReadAhead)
+                SQLFreeStmt(owner->GetHandle(), SQL_CLOSE);
+            else if (freeCallback_.IsEmpty())
+                owner->FreeStopped(NanUndefined());
+            else
+                owner->FreeStopped(NanNew(freeCallback_));
+
+            if (!waiting_)
+                return CompleteWithoutCallback();
+
+            waiting_ = false;
+
+            Handle<Value> argv[] = { NanUndefined(), NanNew<Array>() };
+            MakeCallback(argv);
+        }
+
+        void Finish() {
+            EOS_DEBUG_METHOD();
+
+            finished_ = true;
+
+            // Errors must already have been retrieved, since this clears them
+            rowSets_[0].Unbind(Owner()->GetHandle());
+            rowSets_[0].Release();
+            rowSets_[1].Release();
+
+            Owner()->SetReadAhead(Handle<Object>());
+        }
+
+        SQLULEN rowCount_;
+        RowSet rowSets_[2];
+        int current_;
+        SQLRETURN lastResult_;
+        bool waiting_, ready_, finished_;
+        Statement::ReadAheadStop stop_;
+        Persistent<Function> freeCallback_;
+    };
+}
+
+bool Statement::IsBusy() const {
+    if (readAhead_.IsEmpty())
+        return false;
+
+    auto op = ObjectWrap::Unwrap<ReadAheadOperation>(NanNew(readAhead_));
+    return !op->IsFinished();
+}
+
+void Statement::SetReadAhead(Handle<Object> op) {
+    NanDisposePersistent(readAhead_);
+    if (!op.IsEmpty())
+        NanAssignPersistent(readAhead_, op);
+}
+
+bool Statement::StopReadAhead(ReadAheadStop stop, Handle<Value> freeCallback) {
+    EOS_DEBUG_METHOD();
+
+    if (readAhead_.IsEmpty())
+        return true;
+
+    auto op = ObjectWrap::Unwrap<ReadAheadOperation>(NanNew(readAhead_));
+    if (op->IsFetching()) {
+        op->StopWhenFetched(stop, freeCallback);
+        return false;
+    }
+
+    op->Stop();
+    return true;
+}
+
+bool Statement::FreeWhenStopped(Handle<Value> callback) {
+    EOS_DEBUG_METHOD();
+
+    // A second free() while the first is waiting throws, since the
+    // statement is still busy
+    if (!readAhead_.IsEmpty()) {
+        auto op = ObjectWrap::Unwrap<ReadAheadOperation>(NanNew(readAhead_));
+        if (op->GetStop() == FreeAfterReadAhead)
+            return false;
+    }
+
+    return !StopReadAhead(FreeAfterReadAhead, callback);
+}
+
+NAN_METHOD(Statement::FetchRowsAhead) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 2)
+        return NanThrowError("Statement::FetchRowsAhead() requires a number of rows and a callback");
+
+    if (!args[1]->IsFunction())
+        return NanThrowTypeError("The 2nd argument should be a callback function");
+
+    if (!IsValid())
+        return NanThrowError("This handle has been freed.");
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    if (GetEventHandle())
+        return NanThrowError("fetchRowsAhead is not supported with asynchronous notifications");
+#endif
+
+    if (HasBoundColumns())
+        return NanThrowError("Cannot use fetchRowsAhead while columns are bound with bindColumn");
+
+    // Continue reading ahead
+    if (!readAhead_.IsEmpty()) {
+        auto op = ObjectWrap::Unwrap<ReadAheadOperation>(NanNew(readAhead_));
+        if (op->IsStopping())
+            return NanThrowError("The cursor is being closed");
+
+        if (auto msg = op->Next(args[1].As<Function>()))
+            return NanThrowError(msg);
+
+        NanReturnUndefined();
+    }
+
+    // Start reading ahead, once anything already queued has run
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[0], args[1] };
+    Begin<ReadAheadOperation>(argv);
+
+    if (!readAhead_.IsEmpty())
+        ObjectWrap::Unwrap<ReadAheadOperation>(NanNew(readAhead_))->ReleaseOwner();
+
+    NanReturnUndefined();
+}
+
+template<> Persistent<FunctionTemplate> Operation<Statement, ReadAheadOperation>::constructor_ = Persistent<FunctionTemplate>();
+namespace { ClassInitializer<ReadAheadOperation> ci; }
@@ -0,0 +1,132 @@
+#include "stmt.hpp"
+
+using namespace Eos;
+
+namespace Eos {
+    // Frees the statement handle on the thread pool, since SQLFreeHandle can
+    // have to wait for the server (e.g. to unprepare the statement). The
+    // Statement object acts as if it had been freed as soon as this begins.
+    // If the handle can be recycled, it is reset instead, and given back to
+    // the connection afterwards.
+    struct FreeOperation : Operation<Statement, FreeOperation> {
+        FreeOperation(SQLHSTMT hStmt EOS_ASYNC_ONLY_ARG(HANDLE hEvent), bool recycle, unsigned int generation)
+            : hStmt_(hStmt)
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+            , hEvent_(hEvent)
+#endif
+            , recycle_(recycle)
+            , generation_(generation)
+        {
+            EOS_DEBUG_METHOD_FMT(L"hStmt = 0x%p, recycle = %i", hStmt, recycle);
+        }
+
+        static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
+            EOS_DEBUG_METHOD();
+
+            if (args.Length() < 2)
+                return NanError("Too few arguments");
+
+            auto recycle = owner->CanRecycle();
+            auto generation = owner->GetConnection()->Generation();
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+            HANDLE hEvent = nullptr;
+            auto hStmt = recycle ? owner->DetachHandle(hEvent) : owner->DetachHandle();
+            (new FreeOperation(hStmt, hEvent, recycle, generation))->Wrap(args.Holder());
+#else
+            (new FreeOperation(owner->DetachHandle(), recycle, generation))->Wrap(args.Holder());
+#endif
+
+            EOS_OPERATION_CONSTRUCTOR_RETURN();
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            EOS_DEBUG(L"Final Result: %hi\n", ret);
+
+            if (!SQL_SUCCEEDED(ret)) {
+                Handle<Value> argv[] = { Eos::GetLastError(SQL_HANDLE_STMT, hStmt_) };
+                return MakeCallback(argv);
+            }
+
+            if (recycle_) {
+                auto conn = Owner()->GetConnection();
+
+                // If the connection was disconnected meanwhile, the driver
+                // manager has already freed the handle
+                if (generation_ == conn->Generation())
+                    conn->ReturnStatementHandle(hStmt_ EOS_ASYNC_ONLY_ARG(hEvent_));
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+                else if (hEvent_)
+                    CloseHandle(hEvent_);
+#endif
+            }
+
+            MakeCallback(0, nullptr);
+        }
+
+        static const char* Name() { return "FreeOperation"; }
+
+    protected:
+        SQLRETURN CallOverride() {
+            EOS_DEBUG_METHOD();
+
+            if (recycle_) {
+                auto ret = Statement::ResetHandle(hStmt_);
+                if (SQL_SUCCEEDED(ret))
+                    return ret;
+
+                // Fall back to freeing it
+                recycle_ = false;
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+                if (hEvent_) {
+                    CloseHandle(hEvent_);
+                    hEvent_ = nullptr;
+                }
+#endif
+            }
+
+            return SQLFreeHandle(SQL_HANDLE_STMT, hStmt_);
+        }
+
+    private:
+        SQLHSTMT hStmt_;
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+        HANDLE hEvent_;
+#endif
+        bool recycle_;
+        unsigned int generation_;
+    };
+}
+
+NAN_METHOD(Statement::FreeAsync) {
+    EOS_DEBUG_METHOD();
+
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[0] };
+    return Begin<FreeOperation>(argv);
+}
+
+// Frees the statement when a read-ahead which free() stopped has finished with
+// the handle (see FreeWhenStopped). This is called from the read-ahead's
+// callback, so a FreeOperation waits in the queue until that has completed.
+void Statement::FreeStopped(Handle<Value> callback) {
+    EOS_DEBUG_METHOD();
+
+    if (!callback->IsFunction()) {
+        if (!Recycle())
+            FreeHandle(); // Nobody to tell if this fails
+        return;
+    }
+
+    TryCatch tc;
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), callback };
+    Begin<FreeOperation>(argv);
+    if (tc.HasCaught()) {
+        Handle<Value> error[] = { tc.Exception() };
+        CallbackOnNextTick(callback.As<Function>(), 1, error);
+    }
+}
+
+template<> Persistent<FunctionTemplate> Operation<Statement, FreeOperation>::constructor_ = Persistent<FunctionTemplate>();
+namespace { ClassInitializer<FreeOperation> ci; }
@@ -1,4 +1,5 @@
 #include "stmt.hpp"
+#include "numeric.hpp"
 #include <ctime>
 #include <climits>
 
@@ -12,11 +13,13 @@ namespace Eos {
             , SQLPOINTER buffer
             , SQLLEN bufferLength
             , Handle<Object> bufferHandle
+            , char* pooledBuffer
             , bool raw
             )
             : columnNumber_(columnNumber)
             , sqlType_(sqlType)
             , buffer_(buffer)
+            , pooledBuffer_(pooledBuffer)
             , bufferLength_(bufferLength)
             , totalLength_(0)
             , raw_(raw)
@@ -28,22 +31,15 @@ namespace Eos {
             cType_ = GetCTypeForSQLType(sqlType_);
 
             if (buffer_ == nullptr) {
-                if (cType_ == SQL_C_BINARY 
-                    || cType_ == SQL_C_WCHAR 
-                    || cType_ == SQL_C_CHAR
-                    || raw_)
-                {
-                    NanAssignPersistent(bufferHandle_, JSBuffer::New(65536));
-                
-                    auto msg = JSBuffer::Unwrap(NanNew(bufferHandle_), buffer_, bufferLength_);
-                    assert(msg == nullptr);
-                } else {
-                    buffer_ = &rawValues_;
-                    bufferLength_ = sizeof(rawValues_);
-                }
+                buffer_ = &rawValues_;
+                bufferLength_ = sizeof(rawValues_);
             }
         }
 
+        ~GetDataOperation() {
+            ReturnBuffer();
+        }
+
         static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
             EOS_DEBUG_METHOD();
 
@@ -62,6 +58,7 @@ namespace Eos {
             Handle<Object> bufferHandle;
             SQLPOINTER buffer;
             SQLLEN bufferLength;
+            char* pooledBuffer = nullptr;
             bool raw;
             bool ownBuffer;
 
@@ -87,23 +84,47 @@ namespace Eos {
             
             raw = args[4]->BooleanValue();
 
+            // Strings, binary data and raw values need a buffer big enough for
+            // a chunk of data, which is borrowed until the callback.
+            auto cType = GetCTypeForSQLType(sqlType);
+            if (buffer == nullptr && (cType == SQL_C_BINARY || cType == SQL_C_WCHAR || cType == SQL_C_CHAR || raw)) {
+                pooledBuffer = owner->Pool()->Borrow(ChunkLength);
+                if (!pooledBuffer)
+                    return NanError("Out of memory allocating a buffer for getData");
+
+                buffer = pooledBuffer;
+                bufferLength = ChunkLength;
+            }
+
             (new GetDataOperation(
                 columnNumber, 
                 sqlType, 
                 buffer, bufferLength, bufferHandle,
+                pooledBuffer,
                 raw))->Wrap(args.Holder());
 
             EOS_OPERATION_CONSTRUCTOR_RETURN();
         }
 
+        // The callback reads the buffer, and the next getData could be given
+        // the same one, so only chain when it belongs to this operation
+        bool ChainsOnWorker() { return pooledBuffer_ != nullptr || buffer_ == &rawValues_; }
+
         void CallbackOverride(SQLRETURN ret) {
             EOS_DEBUG_METHOD();
 
-            if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
+            if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA) {
+                ReturnBuffer();
                 return CallbackErrorOverride(ret);
+            }
 
             EOS_DEBUG(L"Final Result: %hi\n", ret);
 
+            // The number of bytes the driver put in the buffer
+            auto bytesInBuffer = totalLength_ == SQL_NO_TOTAL || totalLength_ > bufferLength_
+                ? bufferLength_ 
+                : totalLength_;
+
             Handle<Value> argv[4];
             argv[0] = NanUndefined();
             if (totalLength_ != SQL_NO_TOTAL)
@@ -116,7 +137,10 @@ namespace Eos {
                 argv[1] = NanUndefined();
             else if (totalLength_ == SQL_NULL_DATA)
                 argv[1] = NanNull();
-            else if (raw_) {
+            else if (pooledBuffer_ && (raw_ || cType_ == SQL_C_BINARY)) {
+                // Copy out just the value, so that the buffer can be reused
+                argv[1] = NanNewBufferHandle(pooledBuffer_, static_cast<uint32_t>(bytesInBuffer));
+            } else if (raw_) {
                 assert(!bufferHandle_.IsEmpty());
                 argv[1] = NanNew(bufferHandle_);
             } else if (cType_ == SQL_C_BINARY) {
@@ -125,22 +149,51 @@ namespace Eos {
                 else
                     argv[1] = JSBuffer::Slice(NanNew(bufferHandle_), 0, totalLength_);
             } else {
-                argv[1] = Eos::ConvertToJS(buffer_, totalLength_, bufferLength_, cType_);
+                // Long strings can keep a borrowed buffer until they are collected
+                BufferOwnership ownership(&ReturnBorrowedBuffer, pooledBuffer_, ChunkLength);
+                argv[1] = Eos::ConvertToJS(
+                    buffer_, totalLength_, bufferLength_, cType_, 
+                    pooledBuffer_ ? &ownership : nullptr,
+                    Owner()->GetConversionOptions());
+                if (ownership.taken)
+                    pooledBuffer_ = nullptr;
                 if (argv[1]->IsUndefined())
                     argv[0] = OdbcError("Unable to interpret contents of result buffer");
             }
-            
+
+            ReturnBuffer();
             MakeCallback(argv);
         }
 
         static const char* Name() { return "GetDataOperation"; }
 
+        // The size of the buffer used when none is passed.
+        static const SQLLEN ChunkLength = 65536;
+
     protected:
         SQLRETURN CallOverride() {
             EOS_DEBUG_METHOD();
 
+            auto hStmt = Owner()->GetHandle();
+
+            // SQL_C_NUMERIC values get the column's precision and scale from the
+            // ARD; without them the driver would use a scale of 0.
+            if (cType_ == SQL_C_NUMERIC) {
+                SQLLEN precision, scale;
+                if (SQL_SUCCEEDED(SQLColAttributeW(hStmt, columnNumber_, SQL_DESC_PRECISION, nullptr, 0, nullptr, &precision))
+                    && SQL_SUCCEEDED(SQLColAttributeW(hStmt, columnNumber_, SQL_DESC_SCALE, nullptr, 0, nullptr, &scale))
+                    && SQL_SUCCEEDED(Numerics::SetDescriptor(
+                        hStmt, SQL_ATTR_APP_ROW_DESC, columnNumber_, 
+                        static_cast<SQLSMALLINT>(precision), static_cast<SQLSMALLINT>(scale), nullptr)))
+                {
+                    return SQLGetData(hStmt, columnNumber_, SQL_ARD_TYPE, buffer_, bufferLength_, &totalLength_);
+                }
+
+                cType_ = SQL_C_DOUBLE;
+            }
+
             return SQLGetData(
-                Owner()->GetHandle(),
+                hStmt,
                 columnNumber_,
                 cType_,
                 buffer_, bufferLength_, 
@@ -148,15 +201,27 @@ namespace Eos {
         }
 
     private:
+        void ReturnBuffer() {
+            BufferPool::Return(pooledBuffer_);
+            pooledBuffer_ = nullptr;
+        }
+
+        static void ReturnBorrowedBuffer(void* buffer) {
+            BufferPool::Return(static_cast<char*>(buffer));
+        }
+
         SQLUSMALLINT columnNumber_;
         SQLSMALLINT sqlType_, cType_;
         SQLPOINTER buffer_;
+        char* pooledBuffer_;
         Persistent<Object> bufferHandle_;
         SQLLEN bufferLength_, totalLength_;
 
         union {
             bool b;
             double d;
+            SQLBIGINT i;
+            SQL_NUMERIC_STRUCT n;
             SQL_TIMESTAMP_STRUCT ts;
         } rawValues_;
 
@@ -3,6 +3,8 @@
 #include "eos.hpp"
 #include "conn.hpp"
 #include "handle.hpp"
+#include "result.hpp"
+#include "metadata.hpp"
 
 namespace Eos {
     struct Parameter;
@@ -24,36 +26,131 @@ namespace Eos {
         NAN_METHOD(Prepare);
         NAN_METHOD(ExecDirect);
         NAN_METHOD(Execute);
+        NAN_METHOD(ExecuteBatch);
+        NAN_METHOD(ExecuteWith);
         NAN_METHOD(Fetch);
+        NAN_METHOD(FetchRow);
+        NAN_METHOD(FetchRows);
+        NAN_METHOD(FetchColumns);
+        NAN_METHOD(FetchRowsAhead);
         NAN_METHOD(GetData);
         NAN_METHOD(Cancel);
         NAN_METHOD(NumResultCols);
         NAN_METHOD(DescribeCol);
+        NAN_METHOD(DescribeResultSet);
 
         NAN_METHOD(ParamData);
         NAN_METHOD(PutData);
         NAN_METHOD(MoreResults);
+        NAN_METHOD(Pipeline);
         
         NAN_METHOD(BindParameter);
+        NAN_METHOD(BindParameters);
         NAN_METHOD(SetParameterName);
         NAN_METHOD(UnbindParameters);
 
+        NAN_METHOD(BindColumn);
+        NAN_METHOD(UnbindColumns);
+
         NAN_METHOD(CloseCursor);
+        NAN_METHOD(SetTimestampMode);
+        NAN_METHOD(SetNumericMode);
+        NAN_METHOD(SetRowMode);
+
+        NAN_METHOD(FreeAsync);
 
     public:
 
         // Non-JS methods
         static Handle<FunctionTemplate> Constructor() { return NanNew(constructor_); }
+        bool HasBoundColumns() const { return !columns_.IsEmpty(); }
+        bool HasBoundParameters() const { return !bindings_.IsEmpty(); }
+        BufferPool* Pool() const { return pool_; }
+        const ConversionOptions& GetConversionOptions() const { return options_; }
+        RowShape& GetRowShape() { return rowShape_; }
+        Connection* GetConnection() const { return connection_; }
+
+        // The metadata of the prepared statement, if it came from (or went
+        // into) the connection's metadata cache and the cursor is still on
+        // the first result set; otherwise nullptr.
+        //
+        // Operations change this state in the order they run rather than when
+        // they are queued: SetPrepared and SetFirstResultSet are called from
+        // CallOverride, and read by the operations which run after them. The
+        // metadata's reference count belongs to the main thread, so it is only
+        // replaced by a prepare's callback, and a prepare doesn't let the next
+        // operation start until then (see ChainsOnWorker). While an operation
+        // is running, these should only be read from CallOverride or later.
+        StatementMetadata* CurrentMetadata() const { return prepared_ && firstResultSet_ ? metadata_.Get() : nullptr; }
+        // As above, but regardless of the result set (e.g. for parameters).
+        StatementMetadata* PreparedMetadata() const { return prepared_ ? metadata_.Get() : nullptr; }
+        // The described columns of CurrentMetadata(), or nullptr.
+        const std::vector<ColumnAttributes>* CurrentColumns() const {
+            auto metadata = CurrentMetadata();
+            return metadata ? &metadata->columns : nullptr;
+        }
+        void SetMetadata(StatementMetadata* metadata) { metadata_.Reset(metadata); }
+        void SetFirstResultSet(bool first) { firstResultSet_ = first; }
+
+        // True while reading ahead with fetchRowsAhead.
+        bool IsBusy() const;
+
+        // What happens when the block of rows being read ahead arrives after
+        // closeCursor or free has been called (free wins over closeCursor).
+        enum ReadAheadStop { KeepReadingAhead, CloseAfterReadAhead, FreeAfterReadAhead };
+
+        // The read-ahead operation, which is released at the end of the
+        // result set or on an error, or nothing (an empty handle).
+        void SetReadAhead(Handle<Object> op);
+        void FreeStopped(Handle<Value> callback);
+
+        // Statements run on their connection's thread, if it has one.
+        const void* WorkerAffinity() const { return connection_; }
+
+        // Whether the handle can be reset and given back to the connection
+        // when the statement is freed. Prepared handles are not reused, since
+        // the prepared SQL would survive the reset. Setting this also puts the
+        // cursor back on the first result set.
+        bool CanRecycle() const;
+        void SetPrepared(bool prepared) { prepared_ = prepared; firstResultSet_ = true; }
+
+        // Closes any cursor and unbinds every column and parameter, leaving
+        // the handle as if it had just been allocated (except for a prepared
+        // statement). Safe to call from the thread pool.
+        static SQLRETURN ResetHandle(SQLHSTMT hStmt);
 
     protected:
         
+        Handle<Value> BindOneParameter(int argc, Handle<Value> argv[], Local<Object>& jsParam);
         void AddBoundParameter(Parameter* param);
+        void ReleaseBoundParameters();
         Parameter* GetBoundParameter(SQLUSMALLINT parameterNumber);
 
+        // Returns false if a block is still being fetched, in which case
+        // the read-ahead stops once it has arrived.
+        bool StopReadAhead(ReadAheadStop stop, Handle<Value> freeCallback = Handle<Value>());
+        bool FreeWhenStopped(Handle<Value> callback);
+
+        bool Recycle();
+
     private:
         Persistent<Array> bindings_;
+        Persistent<Array> columns_;
+        Persistent<Object> readAhead_;
+        Persistent<Object> connectionObject_;
+
+        // The parameters in bindings_, so that they can be told when they are
+        // no longer bound (see Parameter::SetStatement), even from the destructor
+        std::vector<Parameter*> boundParameters_;
 
         Connection* connection_;
+        BufferPool* pool_;
+        ConversionOptions options_;
+        RowShape rowShape_;
+        MetadataReference metadata_;
+        bool firstResultSet_;
+        bool prepared_;
+        unsigned int generation_;
 
         static Persistent<FunctionTemplate> constructor_;
     };
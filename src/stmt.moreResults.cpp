@@ -42,6 +42,9 @@ namespace Eos {
         SQLRETURN CallOverride() {
             EOS_DEBUG_METHOD();
 
+            // The prepared statement's metadata only describes the first result set
+            Owner()->SetFirstResultSet(false);
+
             return SQLFetch(
                 Owner()->GetHandle());
         }
@@ -0,0 +1,462 @@
+#include "stmt.hpp"
+#include "parameter.hpp"
+#include "result.hpp"
+#include "metadata.hpp"
+
+#include <vector>
+
+using namespace Eos;
+
+namespace Eos {
+    // Runs a list of steps (prepare, bind, execute, fetchRows, closeCursor and
+    // so on) one after another in a single trip to the thread pool, and calls
+    // back once with the result of every step. The steps stop at the first
+    // one which fails. Everything which needs JS (marshalling the values to
+    // bind, converting fetched rows) happens on the main thread before and
+    // after; the thread pool only makes ODBC calls.
+    struct PipelineOperation : Operation<Statement, PipelineOperation> {
+        enum StepKind {
+            Prepare,
+            ExecDirect,
+            Bind,
+            Execute,
+            FetchRows,
+            MoreResults,
+            CloseCursor
+        };
+
+        struct Step {
+            Step(StepKind kind, Handle<Value> sql)
+                : kind(kind)
+                , sql(sql)
+                , rowCount(0)
+                , rowsAffected(-1)
+                , hasData(false)
+            {
+            }
+
+            StepKind kind;
+            WStringValue sql; // Prepare and ExecDirect
+
+            // Bind
+            std::vector<Parameter*> parameters;
+            std::vector<SQLULEN> columnSizes;
+
+            // Prepare: the statement's cached metadata, if any
+            MetadataReference metadata;
+
+            // FetchRows
+            SQLULEN rowCount;
+            RowSet rowSet;
+
+            // Results
+            SQLLEN rowsAffected;
+            bool hasData;
+
+        private:
+            Step(const Step&); // = delete
+            void operator=(const Step&); // = delete
+        };
+
+        PipelineOperation(std::vector<Step*>& steps, Handle<Array> parameters)
+            : completedSteps_(0)
+            , bound_(false)
+            , fetching_(nullptr)
+            , prepared_(nullptr)
+            , current_(nullptr)
+            , replacesMetadata_(false)
+        {
+            EOS_DEBUG_METHOD_FMT(L"steps = %lu", static_cast<unsigned long>(steps.size()));
+
+            steps_.swap(steps);
+            NanAssignPersistent(parameters_, parameters);
+        }
+
+        ~PipelineOperation() {
+            FreeSteps(steps_);
+            NanDisposePersistent(parameters_);
+        }
+
+        static EOS_OPERATION_CONSTRUCTOR(New, Statement) {
+            EOS_DEBUG_METHOD();
+
+            if (args.Length() < 3)
+                return NanError("Too few arguments");
+
+            if (!args[1]->IsArray() || args[1].As<Array>()->Length() == 0)
+                return NanTypeError("The steps should be a non-empty array");
+
+            // Marshal before creating the operation, which can't be destroyed
+            // without having run.
+            std::vector<Step*> steps;
+            auto parameters = NanNew<Array>();
+            auto error = Marshal(owner, args[1].As<Array>(), steps, parameters);
+            if (!error->IsUndefined()) {
+                FreeSteps(steps);
+                return error;
+            }
+
+            (new PipelineOperation(steps, parameters))->Wrap(args.Holder());
+
+            EOS_OPERATION_CONSTRUCTOR_RETURN();
+        }
+
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            EOS_DEBUG(L"Final Result: %hi, %lu steps completed\n", ret, static_cast<unsigned long>(completedSteps_));
+
+            Handle<Value> argv[] = { NanUndefined(), NanUndefined() };
+
+            // The error has to be retrieved before anything else is done with
+            // the handle, since that clears the diagnostic records
+            if (completedSteps_ < steps_.size()) {
+                auto step = steps_[completedSteps_];
+
+                Handle<Value> error;
+                if (step->rowSet.Error())
+                    error = OdbcError(step->rowSet.Error());
+                else if (ret == SQL_NEED_DATA)
+                    error = OdbcError("Data-at-execution parameters can't be used in a pipeline");
+                else
+                    error = Owner()->GetLastError();
+
+                if (error->IsObject()) {
+                    error.As<Object>()->Set(NanSymbol("step"), NanNew<Integer>(static_cast<int32_t>(completedSteps_)));
+                    error.As<Object>()->Set(NanSymbol("operation"), NanNew<String>(StepName(step->kind)));
+                }
+
+                argv[0] = error;
+            }
+
+            auto hStmt = Owner()->GetHandle();
+
+            // A fetch which failed leaves its row set bound, and parameters
+            // bound by the pipeline would point at buffers which are about to
+            // be released
+            if (fetching_)
+                fetching_->rowSet.Unbind(hStmt);
+            if (bound_)
+                SQLFreeStmt(hStmt, SQL_RESET_PARAMS);
+
+            // The steps which ran have already changed the statement's flags;
+            // the metadata of the last statement prepared (if any) can only
+            // be replaced on the main thread
+            if (replacesMetadata_)
+                Owner()->SetMetadata(prepared_);
+
+            auto results = NanNew<Array>(static_cast<int>(completedSteps_));
+            for (size_t i = 0; i < completedSteps_; i++)
+                results->Set(static_cast<uint32_t>(i), StepResult(*steps_[i]));
+            argv[1] = results;
+
+            MakeCallback(argv);
+        }
+
+        static const char* Name() { return "PipelineOperation"; }
+
+        // The callback uses the handle (for errors, and to reset the parameters)
+        bool ChainsOnWorker() { return false; }
+
+    protected:
+        SQLRETURN CallOverride() {
+            EOS_DEBUG_METHOD();
+
+            auto hStmt = Owner()->GetHandle();
+            SQLRETURN ret = SQL_SUCCESS;
+
+            prepared_ = Owner()->PreparedMetadata();
+            current_ = Owner()->CurrentMetadata();
+
+            for (; completedSteps_ < steps_.size(); completedSteps_++) {
+                ret = RunStep(hStmt, *steps_[completedSteps_]);
+                if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
+                    break;
+            }
+
+            return ret;
+        }
+
+    private:
+        // Each step changes the statement's state as it would when called on
+        // its own (see Statement::CurrentMetadata).
+        SQLRETURN RunStep(SQLHSTMT hStmt, Step& step) {
+            SQLRETURN ret;
+
+            switch (step.kind) {
+            case Prepare:
+                Owner()->SetPrepared(true);
+                replacesMetadata_ = true;
+                ret = SQLPrepareW(hStmt, *step.sql, step.sql.length());
+                prepared_ = current_ = SQL_SUCCEEDED(ret) ? step.metadata.Get() : nullptr;
+                return ret;
+
+            case ExecDirect:
+                Owner()->SetPrepared(false);
+                prepared_ = current_ = nullptr;
+                ret = SQLExecDirectW(hStmt, *step.sql, step.sql.length());
+                if (SQL_SUCCEEDED(ret))
+                    SQLRowCount(hStmt, &step.rowsAffected);
+                else if (ret == SQL_NO_DATA)
+                    step.rowsAffected = 0;
+                return ret;
+
+            case Execute:
+                Owner()->SetFirstResultSet(true);
+                current_ = prepared_;
+                ret = SQLExecute(hStmt);
+                if (SQL_SUCCEEDED(ret))
+                    SQLRowCount(hStmt, &step.rowsAffected);
+                else if (ret == SQL_NO_DATA)
+                    step.rowsAffected = 0;
+                return ret;
+
+            case Bind:
+                bound_ = true;
+                for (size_t i = 0; i < step.parameters.size(); i++) {
+                    ret = step.parameters[i]->Bind(hStmt, step.columnSizes[i]);
+                    if (!SQL_SUCCEEDED(ret))
+                        return ret;
+                }
+                return SQL_SUCCESS;
+
+            case FetchRows:
+                fetching_ = &step;
+                ret = step.rowSet.Fetch(hStmt, step.rowCount, current_ ? &current_->columns : nullptr);
+                if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
+                    return ret;
+
+                // The rows stay in the row set's arrays, to be converted in
+                // the callback
+                if (!SQL_SUCCEEDED(step.rowSet.Unbind(hStmt)))
+                    return SQL_ERROR;
+                fetching_ = nullptr;
+                return ret;
+
+            case MoreResults:
+                Owner()->SetFirstResultSet(false);
+                current_ = nullptr;
+                ret = SQLMoreResults(hStmt);
+                step.hasData = SQL_SUCCEEDED(ret);
+                return ret;
+
+            case CloseCursor:
+                return SQLFreeStmt(hStmt, SQL_CLOSE);
+            }
+
+            return SQL_ERROR;
+        }
+
+        Handle<Value> StepResult(Step& step) {
+            switch (step.kind) {
+            case ExecDirect:
+            case Execute:
+                return NanNew<Number>(static_cast<double>(step.rowsAffected));
+
+            case FetchRows: {
+                step.rowSet.SetConversionOptions(Owner()->GetConversionOptions());
+                Handle<Array> rows;
+                if (step.rowSet.ColumnCount() > 0 && step.rowSet.RowsFetched() > 0)
+                    rows = step.rowSet.GetRows(Owner()->GetRowShape());
+                else
+                    rows = NanNew<Array>();
+                step.rowSet.Release();
+                return rows;
+            }
+
+            case MoreResults:
+                return NanNew<Boolean>(step.hasData);
+
+            default:
+                return NanNull();
+            }
+        }
+
+        static const char* StepName(StepKind kind) {
+            switch (kind) {
+            case Prepare: return "prepare";
+            case ExecDirect: return "execDirect";
+            case Bind: return "bind";
+            case Execute: return "execute";
+            case FetchRows: return "fetchRows";
+            case MoreResults: return "moreResults";
+            case CloseCursor: return "closeCursor";
+            }
+
+            return "unknown";
+        }
+
+        static void FreeSteps(std::vector<Step*>& steps) {
+            for (size_t i = 0; i < steps.size(); i++)
+                delete steps[i];
+            steps.clear();
+        }
+
+        // Each step is an object with a single property, e.g. { prepare: sql },
+        // { bind: [values] }, { execute: true } or { fetchRows: 100 }.
+        static Handle<Value> Marshal(
+            Statement* owner,
+            Handle<Array> jsSteps,
+            std::vector<Step*>& steps,
+            Handle<Array> parameters)
+        {
+            auto kPrepare = NanSymbol("prepare");
+            auto kExecDirect = NanSymbol("execDirect");
+            auto kBind = NanSymbol("bind");
+            auto kExecute = NanSymbol("execute");
+            auto kFetchRows = NanSymbol("fetchRows");
+            auto kMoreResults = NanSymbol("moreResults");
+            auto kCloseCursor = NanSymbol("closeCursor");
+
+            for (uint32_t i = 0; i < jsSteps->Length(); i++) {
+                auto jsStep = jsSteps->Get(i);
+                if (!jsStep->IsObject())
+                    return NanTypeError("Every step should be an object");
+
+                auto obj = jsStep.As<Object>();
+                Step* step;
+
+                if (obj->Has(kPrepare) || obj->Has(kExecDirect)) {
+                    auto isPrepare = obj->Has(kPrepare);
+                    auto sql = obj->Get(isPrepare ? kPrepare : kExecDirect);
+                    if (!sql->IsString())
+                        return NanTypeError("Statement SQL should be a string");
+
+                    steps.push_back(step = new Step(isPrepare ? Prepare : ExecDirect, sql));
+
+                    if (isPrepare) {
+                        auto& cache = owner->GetConnection()->GetMetadataCache();
+                        step->metadata.Reset(cache.Find(*step->sql, step->sql.length()));
+                    }
+                } else if (obj->Has(kBind)) {
+                    auto values = obj->Get(kBind);
+                    if (!values->IsArray())
+                        return NanTypeError("The values to bind should be an array");
+
+                    // The pipeline resets the parameters when it finishes
+                    if (owner->HasBoundParameters())
+                        return NanError("Cannot bind values in a pipeline while parameters are bound with bindParameter");
+
+                    steps.push_back(step = new Step(Bind, NanNew<String>("")));
+
+                    auto error = MarshalValues(owner, values.As<Array>(), *step, parameters);
+                    if (!error->IsUndefined())
+                        return error;
+                } else if (obj->Has(kExecute)) {
+                    steps.push_back(new Step(Execute, NanNew<String>("")));
+                } else if (obj->Has(kFetchRows)) {
+                    auto count = obj->Get(kFetchRows);
+                    if (!count->IsUint32() || count->Uint32Value() == 0)
+                        return NanTypeError("The number of rows must be a positive integer");
+
+                    // fetchRows binds (and afterwards unbinds) every column itself
+                    if (owner->HasBoundColumns())
+                        return NanError("Cannot use fetchRows while columns are bound with bindColumn");
+
+                    steps.push_back(step = new Step(FetchRows, NanNew<String>("")));
+                    step->rowCount = count->Uint32Value();
+                } else if (obj->Has(kMoreResults)) {
+                    steps.push_back(new Step(MoreResults, NanNew<String>("")));
+                } else if (obj->Has(kCloseCursor)) {
+                    steps.push_back(new Step(CloseCursor, NanNew<String>("")));
+                } else {
+                    return NanTypeError("Unknown pipeline step");
+                }
+            }
+
+            return NanUndefined();
+        }
+
+        // Chooses an SQL type for each value from its JavaScript type, as
+        // Connection.query does, and creates input parameters for them.
+        static Handle<Value> MarshalValues(Statement* owner, Handle<Array> values, Step& step, Handle<Array> parameters) {
+            if (values->Length() > USHRT_MAX)
+                return NanRangeError("There are too many values");
+
+            for (uint32_t i = 0; i < values->Length(); i++) {
+                Handle<Value> value = values->Get(i);
+                SQLSMALLINT sqlType = SQL_WVARCHAR, decimalDigits = 0;
+                SQLULEN columnSize = 0;
+
+                if (value->IsNull() || value->IsUndefined()) {
+                    // undefined would make it a data-at-execution parameter
+                    value = NanNull();
+                    columnSize = 1;
+                } else if (value->IsNumber()) {
+                    sqlType = value->IsInt32() ? SQL_INTEGER : SQL_DOUBLE;
+                } else if (value->IsBoolean()) {
+                    sqlType = SQL_BIT;
+                } else if (value->IsDate()) {
+                    sqlType = SQL_TYPE_TIMESTAMP;
+                    columnSize = 23;
+                    decimalDigits = 3;
+                } else if (Buffer::HasInstance(value) || JSBuffer::HasInstance(value)) {
+                    SQLPOINTER buffer;
+                    SQLLEN length;
+                    auto msg = JSBuffer::Unwrap(value.As<Object>(), buffer, length);
+                    if (msg)
+                        return NanError(msg);
+
+                    // A size of 0 means varbinary(max)
+                    sqlType = SQL_VARBINARY;
+                    columnSize = length > 0 && length <= 8000 ? length : 0;
+                } else {
+                    // A size of 0 means nvarchar(max)
+                    value = value->ToString();
+                    auto length = value.As<String>()->Length();
+                    columnSize = length > 0 && length <= 4000 ? length : 0;
+                }
+
+                Handle<Object> jsParam;
+                auto msg = Parameter::Marshal(
+                    owner->Pool(), static_cast<SQLUSMALLINT>(i + 1), SQL_PARAM_INPUT,
+                    sqlType, decimalDigits, value, Handle<Object>(), jsParam);
+                if (msg)
+                    return NanError(msg);
+
+                parameters->Set(parameters->Length(), jsParam);
+                step.parameters.push_back(Parameter::Unwrap(jsParam));
+                step.columnSizes.push_back(columnSize);
+            }
+
+            return NanUndefined();
+        }
+
+        std::vector<Step*> steps_;
+        size_t completedSteps_;
+
+        // Whether a bind step has run, and the fetch step which failed, if
+        // any, so that the callback can undo them
+        bool bound_;
+        Step* fetching_;
+
+        // The metadata of the prepared statement and of the current result
+        // set as the steps run, and whether a prepare step ran. The metadata
+        // is kept alive by the steps or the statement until the callback.
+        StatementMetadata* prepared_;
+        StatementMetadata* current_;
+        bool replacesMetadata_;
+
+        Persistent<Array> parameters_;
+    };
+}
+
+NAN_METHOD(Statement::Pipeline) {
+    EOS_DEBUG_METHOD();
+
+    if (args.Length() < 2)
+        return NanThrowError("Statement::Pipeline() requires an array of steps and a callback");
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+    // A pipeline makes many ODBC calls, which cannot be completed using a
+    // single asynchronous notification.
+    if (GetEventHandle())
+        return NanThrowError("pipeline is not supported with asynchronous notifications");
+#endif
+
+    Handle<Value> argv[] = { NanObjectWrapHandle(this), args[0], args[1] };
+    return Begin<PipelineOperation>(argv);
+}
+
+template<> Persistent<FunctionTemplate> Operation<Statement, PipelineOperation>::constructor_ = Persistent<FunctionTemplate>();
+namespace { ClassInitializer<PipelineOperation> ci; }
@@ -1,8 +1,13 @@
 #include "stmt.hpp"
+#include "metadata.hpp"
 
 using namespace Eos;
 
 namespace Eos {
+    // Prepares the statement and, unless the connection's metadata cache
+    // already has them, describes its result columns and parameters while
+    // still on the thread pool, so that later statements with the same SQL
+    // don't need to.
     struct PrepareOperation : Operation<Statement, PrepareOperation> {
         PrepareOperation(Handle<Value> sql)
             : sql_(sql)
@@ -19,24 +24,77 @@ namespace Eos {
             if (!args[1]->IsString())
                 return NanTypeError("Statement SQL should be a string");
 
-            (new PrepareOperation(args[1]))->Wrap(args.Holder());
+            auto op = new PrepareOperation(args[1]);
+            op->Wrap(args.Holder());
+
+            auto& cache = owner->GetConnection()->GetMetadataCache();
+            op->metadata_.Reset(cache.Find(*op->sql_, op->sql_.length()));
 
             EOS_OPERATION_CONSTRUCTOR_RETURN();
         }
 
+        void CallbackOverride(SQLRETURN ret) {
+            EOS_DEBUG_METHOD();
+
+            // The previously prepared statement (if any) has been replaced,
+            // even if this one failed
+            if (!SQL_SUCCEEDED(ret)) {
+                Owner()->SetMetadata(nullptr);
+                return CallbackErrorOverride(ret);
+            }
+
+            if (described_.Get()) {
+                Owner()->GetConnection()->GetMetadataCache().Insert(*sql_, sql_.length(), described_.Get());
+                Owner()->SetMetadata(described_.Get());
+            } else {
+                Owner()->SetMetadata(metadata_.Get());
+            }
+
+            MakeCallback(0, nullptr);
+        }
+
         static const char* Name() { return "PrepareOperation"; }
 
+        // The statement's metadata is replaced by the callback, which has to
+        // happen before the next operation looks at it
+        bool ChainsOnWorker() { return false; }
+
     protected:
         SQLRETURN CallOverride() {
             EOS_DEBUG_METHOD();
 
-            return SQLPrepareW(
-                Owner()->GetHandle(), 
-                *sql_, sql_.length());
+            Owner()->SetPrepared(true);
+
+            auto hStmt = Owner()->GetHandle();
+            auto ret = SQLPrepareW(hStmt, *sql_, sql_.length());
+            if (!SQL_SUCCEEDED(ret) || metadata_.Get())
+                return ret;
+
+#if defined(EOS_ENABLE_ASYNC_NOTIFICATIONS)
+            // Describing takes more ODBC calls, which can't be completed with
+            // the one notification.
+            if (Owner()->GetEventHandle())
+                return ret;
+#endif
+
+            // Failing to describe the statement doesn't make the prepare fail;
+            // the statement just isn't cached. (The metadata is not shared until
+            // the callback, so creating it here is safe.)
+            auto metadata = new(nothrow) StatementMetadata();
+            if (!metadata)
+                return ret;
+
+            if (SQL_SUCCEEDED(metadata->Describe(hStmt)))
+                described_.Take(metadata);
+            else
+                metadata->Release();
+
+            return ret;
         }
 
     protected:
         WStringValue sql_;
+        MetadataReference metadata_, described_;
     };
 }
 
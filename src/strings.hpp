@@ -3,6 +3,21 @@
 #include <sql.h>
 #include <string>
 #include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EOS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define EOS_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 // If it isn't, things will be very broken when passing from ODBC to V8
 static_assert(sizeof(SQLWCHAR) == 2, "SQLWCHAR should be two bytes");
@@ -14,11 +29,79 @@ inline std::wstring sqlstring(const SQLWCHAR* str) {
     return wstr;
 }
 
+// The wide string functions below process 8 or 16 characters at a time with SSE2
+// where it is available (always, on x64), and 32 with AVX2 if the compiler is allowed
+// to use it. Otherwise they fall back to one character at a time.
+
+namespace sqlwcs_detail {
+    inline int ctz(unsigned mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+#if defined(EOS_SSE2)
+    // True if 16 bytes can be read from p without crossing into the next page, which
+    // makes it safe to read past the end of a null-terminated string.
+    inline bool CanLoad16(const void* p) {
+        return (reinterpret_cast<std::uintptr_t>(p) & 4095) <= 4096 - 16;
+    }
+
+    inline __m128i Load16(const SQLWCHAR* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+#endif
+}
+
 inline std::size_t sqlwcslen(const SQLWCHAR* str) {
-    std::size_t len = 0;
-    while (*str++)
-        len++;
-    return len;
+    const SQLWCHAR* p = str;
+
+#if defined(EOS_SSE2)
+    // Aligned loads never cross a page boundary, so find the terminator one character
+    // at a time until p is aligned.
+    for (; reinterpret_cast<std::uintptr_t>(p) & 15; p++)
+        if (!*p)
+            return p - str;
+
+    const __m128i zero = _mm_setzero_si128();
+    for (;; p += 8) {
+        auto chars = _mm_load_si128(reinterpret_cast<const __m128i*>(p));
+        auto mask = _mm_movemask_epi8(_mm_cmpeq_epi16(chars, zero));
+        if (mask)
+            return (p - str) + sqlwcs_detail::ctz(mask) / 2;
+    }
+#else
+    while (*p)
+        p++;
+    return p - str;
+#endif
+}
+
+inline int sqlwcscmp(const SQLWCHAR* x, const SQLWCHAR* y) {
+#if defined(EOS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+
+    // Stop at the first difference or terminator in each block of 8 characters
+    for (; sqlwcs_detail::CanLoad16(x) && sqlwcs_detail::CanLoad16(y); x += 8, y += 8) {
+        auto cx = sqlwcs_detail::Load16(x), cy = sqlwcs_detail::Load16(y);
+        auto different = ~_mm_movemask_epi8(_mm_cmpeq_epi16(cx, cy)) & 0xFFFF;
+        auto end = _mm_movemask_epi8(_mm_cmpeq_epi16(cx, zero));
+
+        if (different | end) {
+            auto i = sqlwcs_detail::ctz(different | end) / 2;
+            return (int)x[i] - (int)y[i];
+        }
+    }
+#endif
+
+    for (; *x || *y; x++, y++)
+        if (*x != *y)
+            return (int)*x - (int)*y;
+    return 0;
 }
 
 template<typename U>
@@ -29,6 +112,49 @@ inline int sqlwcscmp(const SQLWCHAR* x, const U* y) {
     return 0;
 }
 
+// Copies length characters from src to dst as single bytes, provided that none of
+// them is greater than maxChar (0x7F for ASCII, or 0xFF for Latin-1). The check and
+// the copy are done in one pass, so if false is returned, dst holds part of a copy.
+inline bool sqlwcsnarrow(const SQLWCHAR* src, std::size_t length, unsigned char* dst, SQLWCHAR maxChar) {
+    std::size_t i = 0;
+
+#if defined(EOS_AVX2)
+    const __m256i wide256 = _mm256_set1_epi16(static_cast<short>(static_cast<SQLWCHAR>(~maxChar)));
+    for (; i + 32 <= length; i += 32) {
+        auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), wide256))
+            return false;
+
+        // packus works within each 128-bit lane, so put the 64-bit quarters back in order
+        auto narrow = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), narrow);
+    }
+#endif
+
+#if defined(EOS_SSE2)
+    const __m128i wide = _mm_set1_epi16(static_cast<short>(static_cast<SQLWCHAR>(~maxChar)));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        auto a = sqlwcs_detail::Load16(src + i);
+        auto b = sqlwcs_detail::Load16(src + i + 8);
+        auto tooWide = _mm_and_si128(_mm_or_si128(a, b), wide);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(tooWide, zero)) != 0xFFFF)
+            return false;
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+    }
+#endif
+
+    for (; i < length; i++) {
+        if (src[i] > maxChar)
+            return false;
+        dst[i] = static_cast<unsigned char>(src[i]);
+    }
+
+    return true;
+}
+
 inline void sqlwcsncpy(SQLWCHAR* dst, const SQLWCHAR* src, std::size_t count) {
     while (count --> 0) {
         if (src) {
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <sql.h>
+#include <sqlext.h>
+#include <cmath>
+
+// Conversion between SQL_TIMESTAMP_STRUCT (taken as UTC) and milliseconds since
+// the Unix epoch, using the proleptic Gregorian calendar like JavaScript's Date.
+// This is plain arithmetic (see Howard Hinnant's "chrono-Compatible Low-Level
+// Date Algorithms"), so unlike gmtime/timelocal it never touches the C library's
+// time zone state.
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define EOS_CONSTEXPR inline
+#else
+#define EOS_CONSTEXPR constexpr
+#define EOS_HAS_CONSTEXPR
+#endif
+
+namespace Eos {
+    namespace Timestamps {
+        struct CivilDate {
+            EOS_CONSTEXPR CivilDate(long long year, unsigned month, unsigned day)
+                : year(year), month(month), day(day) {}
+
+            long long year;
+            unsigned month, day;
+        };
+
+        namespace detail {
+            // Years are counted from March, so that the leap day is the last day
+            // of the year, in 400-year eras of 146097 days.
+
+            EOS_CONSTEXPR long long EraOfYear(long long y) {
+                return (y >= 0 ? y : y - 399) / 400;
+            }
+
+            EOS_CONSTEXPR long long DayOfYear(unsigned m, unsigned d) {
+                return (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+            }
+
+            EOS_CONSTEXPR long long DayOfEra(long long yearOfEra, long long dayOfYear) {
+                return yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+            }
+
+            EOS_CONSTEXPR long long DaysFromMarchYear(long long y, unsigned m, unsigned d) {
+                return EraOfYear(y) * 146097 + DayOfEra(y - EraOfYear(y) * 400, DayOfYear(m, d)) - 719468;
+            }
+
+            EOS_CONSTEXPR long long EraOfDays(long long z) {
+                return (z >= 0 ? z : z - 146096) / 146097;
+            }
+
+            EOS_CONSTEXPR long long YearOfEra(long long dayOfEra) {
+                return (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            }
+
+            EOS_CONSTEXPR long long DayOfYearOfEra(long long dayOfEra) {
+                return dayOfEra - (365 * YearOfEra(dayOfEra) + YearOfEra(dayOfEra) / 4 - YearOfEra(dayOfEra) / 100);
+            }
+
+            EOS_CONSTEXPR unsigned MonthIndex(long long dayOfYear) {
+                return static_cast<unsigned>((5 * dayOfYear + 2) / 153);
+            }
+
+            EOS_CONSTEXPR unsigned Month(long long dayOfYear) {
+                return MonthIndex(dayOfYear) < 10 ? MonthIndex(dayOfYear) + 3 : MonthIndex(dayOfYear) - 9;
+            }
+
+            EOS_CONSTEXPR unsigned Day(long long dayOfYear) {
+                return static_cast<unsigned>(dayOfYear - (153 * MonthIndex(dayOfYear) + 2) / 5 + 1);
+            }
+
+            EOS_CONSTEXPR CivilDate FromMarchYear(long long y, long long dayOfYear) {
+                return CivilDate(y + (Month(dayOfYear) <= 2), Month(dayOfYear), Day(dayOfYear));
+            }
+
+            EOS_CONSTEXPR CivilDate FromEra(long long era, long long dayOfEra) {
+                return FromMarchYear(YearOfEra(dayOfEra) + era * 400, DayOfYearOfEra(dayOfEra));
+            }
+        }
+
+        // The number of days from 1970-01-01 to the given date.
+        EOS_CONSTEXPR long long DaysFromCivil(long long y, unsigned m, unsigned d) {
+            return detail::DaysFromMarchYear(m <= 2 ? y - 1 : y, m, d);
+        }
+
+        // The date which is the given number of days from 1970-01-01.
+        EOS_CONSTEXPR CivilDate CivilFromDays(long long days) {
+            return detail::FromEra(
+                detail::EraOfDays(days + 719468),
+                days + 719468 - detail::EraOfDays(days + 719468) * 146097);
+        }
+
+#if defined(EOS_HAS_CONSTEXPR)
+        static_assert(DaysFromCivil(1970, 1, 1) == 0, "DaysFromCivil is broken");
+        static_assert(DaysFromCivil(2000, 3, 1) == 11017, "DaysFromCivil is broken");
+        static_assert(DaysFromCivil(1969, 12, 31) == -1, "DaysFromCivil is broken");
+        static_assert(CivilFromDays(11016).month == 2 && CivilFromDays(11016).day == 29, "CivilFromDays is broken");
+        static_assert(CivilFromDays(-1).year == 1969, "CivilFromDays is broken");
+#endif
+
+        const long long MillisecondsPerDay = 86400000;
+
+        inline double ToEpochMilliseconds(const SQL_TIMESTAMP_STRUCT& ts) {
+            auto days = DaysFromCivil(ts.year, ts.month, ts.day);
+            auto ms = ((ts.hour * 60 + ts.minute) * 60 + ts.second) * 1000LL;
+            return double(days * MillisecondsPerDay + ms) + ts.fraction / 1000000.0;
+        }
+
+        // Returns false if the time is not finite or the year does not fit in
+        // a SQL_TIMESTAMP_STRUCT.
+        inline bool FromEpochMilliseconds(double time, SQL_TIMESTAMP_STRUCT& ts) {
+            // +/-100,000,000 days is the range of a JavaScript Date
+            if (!(std::fabs(time) <= 8.64e15))
+                return false;
+
+            auto ms = static_cast<long long>(std::floor(time));
+            auto days = ms / MillisecondsPerDay;
+            auto msOfDay = ms % MillisecondsPerDay;
+            if (msOfDay < 0) {
+                days--;
+                msOfDay += MillisecondsPerDay;
+            }
+
+            auto date = CivilFromDays(days);
+            if (date.year < -32768 || date.year > 32767)
+                return false;
+
+            ts.year = static_cast<SQLSMALLINT>(date.year);
+            ts.month = static_cast<SQLUSMALLINT>(date.month);
+            ts.day = static_cast<SQLUSMALLINT>(date.day);
+            ts.hour = static_cast<SQLUSMALLINT>(msOfDay / 3600000);
+            ts.minute = static_cast<SQLUSMALLINT>(msOfDay / 60000 % 60);
+            ts.second = static_cast<SQLUSMALLINT>(msOfDay / 1000 % 60);
+            ts.fraction = static_cast<SQLUINTEGER>(msOfDay % 1000) * 1000000;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,352 @@
+#include "workers.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+using namespace Eos;
+
+namespace {
+    struct Lane;
+
+    struct Thread {
+        uv_thread_t id;
+        Lane* lane;
+        Thread* next;
+    };
+
+    // A queue of work and the threads which take work from it: the shared
+    // lane, or the lane of a pinned connection (which has one thread).
+    struct Lane {
+        Lane() : first(nullptr), last(nullptr), threads(0), exiting(0) {
+            uv_cond_init(&ready);
+        }
+
+        ~Lane() {
+            uv_cond_destroy(&ready);
+        }
+
+        WorkItem *first, *last;
+        uv_cond_t ready;
+
+        // The number of threads running, and how many of them should exit
+        // once there is no work left.
+        int threads, exiting;
+    };
+
+    // Guards the lanes' queues and threads, and everything below up to the
+    // main thread only state.
+    uv_mutex_t mutex;
+    uv_async_t* async = nullptr;
+
+    Lane* shared = nullptr;
+    WorkItem *firstDone = nullptr, *lastDone = nullptr;
+    Thread* finished = nullptr;
+    int busy = 0, queued = 0, maxQueued = 0;
+
+    // Main thread only
+    std::map<const void*, Lane*> pinned;
+    int sharedThreads = WorkerPool::DefaultThreads;
+    bool pinConnections = false;
+    double completed = 0;
+
+    // Work which hasn't been called back yet, and threads which are exiting
+    // but haven't been joined. The loop is kept alive while there are any.
+    int outstanding = 0;
+
+    void AddOutstanding(int count) {
+        if (outstanding == 0 && count > 0)
+            uv_ref(reinterpret_cast<uv_handle_t*>(async));
+        outstanding += count;
+    }
+
+    void RemoveOutstanding() {
+        if (--outstanding == 0)
+            uv_unref(reinterpret_cast<uv_handle_t*>(async));
+    }
+
+    void WorkerMain(void* arg) {
+        auto thread = static_cast<Thread*>(arg);
+        auto lane = thread->lane;
+
+        uv_mutex_lock(&mutex);
+
+        for (;;) {
+            auto item = lane->first;
+
+            if (!item) {
+                if (lane->exiting > 0) {
+                    lane->exiting--;
+                    break;
+                }
+
+                uv_cond_wait(&lane->ready, &mutex);
+                continue;
+            }
+
+            lane->first = item->next;
+            if (!lane->first)
+                lane->last = nullptr;
+
+            queued--;
+
+            while (item) {
+                busy++;
+                uv_mutex_unlock(&mutex);
+
+                item->then = nullptr;
+                item->Work(item);
+
+                // The main thread may be done with the item as soon as it is
+                // on the done list
+                auto then = item->then;
+
+                uv_mutex_lock(&mutex);
+                busy--;
+
+                item->next = nullptr;
+                if (lastDone)
+                    lastDone->next = item;
+                else
+                    firstDone = item;
+                lastDone = item;
+
+                uv_async_send(async);
+
+                item = then;
+            }
+        }
+
+        // The main thread joins the thread and deletes its record
+        lane->threads--;
+        thread->next = finished;
+        finished = thread;
+        uv_async_send(async);
+
+        uv_mutex_unlock(&mutex);
+    }
+
+    void StartThread(Lane* lane) {
+        auto thread = new Thread();
+        thread->lane = lane;
+        thread->next = nullptr;
+
+        uv_mutex_lock(&mutex);
+        lane->threads++;
+        uv_mutex_unlock(&mutex);
+
+        // As the libuv thread pool does, give up if a thread can't be started
+        if (uv_thread_create(&thread->id, &WorkerMain, thread)) {
+            fprintf(stderr, "eos: failed to start a worker thread\n");
+            abort();
+        }
+    }
+
+    // Starts or stops shared threads so that there are sharedThreads of them.
+    void ResizeShared() {
+        uv_mutex_lock(&mutex);
+        auto change = sharedThreads - (shared->threads - shared->exiting);
+        if (change < 0) {
+            shared->exiting -= change;
+            uv_cond_broadcast(&shared->ready);
+        }
+        uv_mutex_unlock(&mutex);
+
+        if (change < 0)
+            AddOutstanding(-change);
+
+        for (; change > 0; change--)
+            StartThread(shared);
+    }
+
+#ifdef NODE_12
+    void ProcessCompletions(uv_async_t*) {
+#else
+    void ProcessCompletions(uv_async_t*, int) {
+#endif
+        uv_mutex_lock(&mutex);
+        auto item = firstDone;
+        firstDone = lastDone = nullptr;
+        auto thread = finished;
+        finished = nullptr;
+        uv_mutex_unlock(&mutex);
+
+        while (thread) {
+            auto next = thread->next;
+
+            // The thread has finished with the lane, and is about to return
+            uv_thread_join(&thread->id);
+            if (thread->lane != shared)
+                delete thread->lane;
+            delete thread;
+
+            RemoveOutstanding();
+
+            thread = next;
+        }
+
+        while (item) {
+            // Done may queue the same item again
+            auto next = item->next;
+
+            completed++;
+            RemoveOutstanding();
+
+            item->Done(item);
+            item = next;
+        }
+    }
+
+    void Initialise() {
+        if (async)
+            return;
+
+        uv_mutex_init(&mutex);
+        shared = new Lane();
+
+        // Only referenced while there is work outstanding, so that the worker
+        // pool doesn't keep the process alive
+        async = new uv_async_t();
+        uv_async_init(uv_default_loop(), async, &ProcessCompletions);
+        uv_unref(reinterpret_cast<uv_handle_t*>(async));
+
+        ResizeShared();
+    }
+}
+
+void WorkerPool::Init(Handle<Object> exports) {
+    EOS_DEBUG_METHOD();
+
+    auto size = getenv("EOS_THREADPOOL_SIZE");
+    if (size && atoi(size) > 0)
+        sharedThreads = min(atoi(size), static_cast<int>(MaxThreads));
+
+    exports->Set(
+        NanSymbol("configureWorkers"),
+        NanNew<FunctionTemplate, NanFunctionCallback>(&Configure)->GetFunction(),
+        (PropertyAttribute)(ReadOnly | DontDelete));
+    exports->Set(
+        NanSymbol("workerStats"),
+        NanNew<FunctionTemplate, NanFunctionCallback>(&Stats)->GetFunction(),
+        (PropertyAttribute)(ReadOnly | DontDelete));
+}
+
+void WorkerPool::Queue(WorkItem* item, const void* affinity) {
+    Initialise();
+
+    auto lane = shared;
+    auto start = false;
+
+    if (pinConnections && affinity) {
+        auto it = pinned.find(affinity);
+        if (it != pinned.end()) {
+            lane = it->second;
+        } else {
+            lane = pinned[affinity] = new Lane();
+            start = true;
+        }
+    }
+
+    AddOutstanding(1);
+
+    item->next = nullptr;
+
+    uv_mutex_lock(&mutex);
+    if (lane->last)
+        lane->last->next = item;
+    else
+        lane->first = item;
+    lane->last = item;
+
+    queued++;
+    maxQueued = max(maxQueued, queued);
+
+    uv_cond_signal(&lane->ready);
+    uv_mutex_unlock(&mutex);
+
+    if (start)
+        StartThread(lane);
+}
+
+void WorkerPool::Hold() {
+    Initialise();
+    AddOutstanding(1);
+}
+
+void WorkerPool::Release() {
+    RemoveOutstanding();
+}
+
+void WorkerPool::Unpin(const void* affinity) {
+    auto it = pinned.find(affinity);
+    if (it == pinned.end())
+        return;
+
+    auto lane = it->second;
+    pinned.erase(it);
+
+    uv_mutex_lock(&mutex);
+    lane->exiting = lane->threads;
+    uv_cond_signal(&lane->ready);
+    uv_mutex_unlock(&mutex);
+
+    AddOutstanding(1);
+}
+
+NAN_METHOD(WorkerPool::Configure) {
+    EOS_DEBUG_METHOD();
+
+    NanScope();
+
+    if (args.Length() < 1 || !args[0]->IsObject())
+        return NanThrowTypeError("The first argument should be an object");
+
+    auto options = args[0]->ToObject();
+    auto threads = options->Get(NanSymbol("threads"));
+    auto pin = options->Get(NanSymbol("pinConnections"));
+
+    if (!threads->IsUndefined()) {
+        if (!threads->IsInt32() || threads->Int32Value() < 1 || threads->Int32Value() > MaxThreads)
+            return NanThrowRangeError("The number of threads should be an integer from 1 to 128");
+
+        sharedThreads = threads->Int32Value();
+        if (async)
+            ResizeShared();
+    }
+
+    // Connections already pinned keep their threads until they disconnect
+    if (!pin->IsUndefined())
+        pinConnections = pin->BooleanValue();
+
+    NanReturnUndefined();
+}
+
+NAN_METHOD(WorkerPool::Stats) {
+    EOS_DEBUG_METHOD();
+
+    NanScope();
+
+    int threads = 0, exiting = 0, busyNow = 0, queuedNow = 0, maxQueuedNow = 0;
+    if (async) {
+        uv_mutex_lock(&mutex);
+        threads = shared->threads;
+        exiting = shared->exiting;
+        busyNow = busy;
+        queuedNow = queued;
+        maxQueuedNow = maxQueued;
+        uv_mutex_unlock(&mutex);
+    }
+
+    auto stats = NanNew<Object>();
+    stats->Set(NanSymbol("threads"), NanNew<Integer>(async ? threads - exiting : sharedThreads));
+    stats->Set(NanSymbol("pinnedThreads"), NanNew<Integer>(static_cast<int32_t>(pinned.size())));
+    stats->Set(NanSymbol("pinConnections"), NanNew<Boolean>(pinConnections));
+    stats->Set(NanSymbol("busy"), NanNew<Integer>(busyNow));
+    stats->Set(NanSymbol("queued"), NanNew<Integer>(queuedNow));
+    stats->Set(NanSymbol("maxQueued"), NanNew<Integer>(maxQueuedNow));
+    stats->Set(NanSymbol("completed"), NanNew<Number>(completed));
+
+    NanReturnValue(stats);
+}
+
+namespace { ClassInitializer<WorkerPool> ci; }
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "eos.hpp"
+
+#include <uv.h>
+
+namespace Eos {
+    // A piece of work for the worker threads. Work is called on a worker
+    // thread, and then Done on the main thread. If Work sets then, that item
+    // is run next on the same thread, without being queued (its Done must
+    // have been accounted for with Hold).
+    struct WorkItem {
+        void (*Work)(WorkItem* item);
+        void (*Done)(WorkItem* item);
+        void* data;
+        WorkItem* next;
+        WorkItem* then;
+    };
+
+    // Eos runs blocking ODBC calls on threads of its own rather than on the
+    // libuv thread pool, so that slow queries can't hold up fs, dns and crypto
+    // work (which share libuv's 4 threads by default).
+    //
+    // Work is shared between the pool's threads, unless connections are
+    // pinned, in which case every connection gets a thread of its own, which
+    // runs the work of the connection and its statements in order.
+    //
+    // Queue must be called on the main thread. Done is called on the main
+    // thread too, via a uv_async_t on the default loop, in the order that the
+    // work completed.
+    struct WorkerPool {
+        static const int DefaultThreads = 4;
+        static const int MaxThreads = 128;
+
+        static void Init(Handle<Object> exports);
+
+        // Affinity identifies the connection for pinning, or is nullptr.
+        static void Queue(WorkItem* item, const void* affinity);
+
+        // Keeps the loop alive for an item which will be started by another
+        // (see WorkItem::then), until its Done is called. Release undoes a
+        // Hold for an item which is queued or dropped instead.
+        static void Hold();
+        static void Release();
+
+        // Stops the connection's pinned thread (if it has one) once the work
+        // queued on it is done.
+        static void Unpin(const void* affinity);
+
+        static NAN_METHOD(Configure);
+        static NAN_METHOD(Stats);
+    };
+}